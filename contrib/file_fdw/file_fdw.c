@@ -12,10 +12,12 @@
  */
 #include "postgres.h"
 
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 #include "access/htup_details.h"
+#include "access/parallel.h"
 #include "access/reloptions.h"
 #include "access/sysattr.h"
 #include "access/table.h"
@@ -28,12 +30,17 @@
 #include "commands/vacuum.h"
 #include "foreign/fdwapi.h"
 #include "foreign/foreign.h"
+#include "mb/pg_wchar.h"
 #include "miscadmin.h"
 #include "nodes/makefuncs.h"
+#include "optimizer/cost.h"
 #include "optimizer/optimizer.h"
 #include "optimizer/pathnode.h"
+#include "optimizer/paths.h"
 #include "optimizer/planmain.h"
 #include "optimizer/restrictinfo.h"
+#include "port/atomics.h"
+#include "storage/fd.h"
 #include "utils/acl.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
@@ -101,6 +108,26 @@ typedef struct FileFdwPlanState
 	double		ntuples;		/* estimate of number of data rows */
 } FileFdwPlanState;
 
+/*
+ * Size of the parts that a file is divided into for a parallel scan.
+ */
+#define FILE_FDW_CHUNK_SIZE		(1024 * 1024)
+
+/*
+ * Shared state of a parallel scan.  Participants claim chunks of the file in
+ * order, and each reads the lines that begin within the chunks it claimed.
+ */
+typedef struct FileFdwParallelState
+{
+	uint64		file_size;		/* size of the file when the scan began */
+	uint64		chunk_size;		/* size of each chunk */
+	bool		whole_file;		/* file can't be split, so the first
+								 * participant to claim it reads all of it */
+	pg_atomic_uint64 next_offset;	/* start of the next unclaimed chunk */
+	pg_atomic_uint64 num_errors;	/* rows skipped by participants that have
+									 * finished reading */
+} FileFdwParallelState;
+
 /*
  * FDW-specific information for ForeignScanState.fdw_state.
  */
@@ -110,9 +137,26 @@ typedef struct FileFdwExecutionState
 	bool		is_program;		/* true if filename represents an OS command */
 	List	   *options;		/* merged COPY options, excluding filename and
 								 * is_program */
-	CopyFromState cstate;		/* COPY execution state */
+	CopyFromState cstate;		/* COPY execution state, or NULL if not yet
+								 * started */
+
+	/* These fields are used only by parallel-aware scans */
+	FileFdwParallelState *pstate;	/* shared state, or NULL if not running in
+									 * parallel after all */
+	int			fd;				/* file being read, or -1 if not open */
+	off_t		chunk_pos;		/* next byte of the current chunk to read */
+	off_t		chunk_end;		/* end of the current chunk, or -1 for EOF */
+	uint64		num_errors;		/* rows skipped in earlier chunks */
+	bool		errors_published;	/* added num_errors to pstate yet? */
+	bool		errors_reported;	/* reported the total skipped rows yet? */
 } FileFdwExecutionState;
 
+/*
+ * The scan whose current chunk file_read_chunk() reads from.  COPY's data
+ * source callback doesn't have an argument we could pass it in.
+ */
+static FileFdwExecutionState *chunk_reader = NULL;
+
 /*
  * SQL functions
  */
@@ -140,11 +184,23 @@ static void fileBeginForeignScan(ForeignScanState *node, int eflags);
 static TupleTableSlot *fileIterateForeignScan(ForeignScanState *node);
 static void fileReScanForeignScan(ForeignScanState *node);
 static void fileEndForeignScan(ForeignScanState *node);
+static void fileShutdownForeignScan(ForeignScanState *node);
 static bool fileAnalyzeForeignTable(Relation relation,
 									AcquireSampleRowsFunc *func,
 									BlockNumber *totalpages);
 static bool fileIsForeignScanParallelSafe(PlannerInfo *root, RelOptInfo *rel,
 										  RangeTblEntry *rte);
+static Size fileEstimateDSMForeignScan(ForeignScanState *node,
+									   ParallelContext *pcxt);
+static void fileInitializeDSMForeignScan(ForeignScanState *node,
+										 ParallelContext *pcxt,
+										 void *coordinate);
+static void fileReInitializeDSMForeignScan(ForeignScanState *node,
+										   ParallelContext *pcxt,
+										   void *coordinate);
+static void fileInitializeWorkerForeignScan(ForeignScanState *node,
+											shm_toc *toc,
+											void *coordinate);
 
 /*
  * Helper functions
@@ -161,8 +217,21 @@ static bool check_selective_binary_conversion(RelOptInfo *baserel,
 static void estimate_size(PlannerInfo *root, RelOptInfo *baserel,
 						  FileFdwPlanState *fdw_private);
 static void estimate_costs(PlannerInfo *root, RelOptInfo *baserel,
-						   FileFdwPlanState *fdw_private,
+						   FileFdwPlanState *fdw_private, int parallel_workers,
 						   Cost *startup_cost, Cost *total_cost);
+static double file_parallel_divisor(int parallel_workers);
+static bool file_is_regular_file(const char *filename);
+static bool file_is_splittable(const char *filename, bool is_program,
+							   List *options);
+static void file_init_parallel_state(FileFdwExecutionState *festate,
+									 FileFdwParallelState *pstate);
+static bool file_begin_next_chunk(ForeignScanState *node);
+static void file_check_end_of_chunk(FileFdwExecutionState *festate);
+static void file_publish_num_errors(FileFdwExecutionState *festate);
+static off_t file_line_start(FileFdwExecutionState *festate, off_t offset);
+static int	file_read_chunk(void *outbuf, int minread, int maxread);
+static int	file_pread(FileFdwExecutionState *festate, void *buf, size_t nbytes,
+					   off_t offset);
 static int	file_acquire_sample_rows(Relation onerel, int elevel,
 									 HeapTuple *rows, int targrows,
 									 double *totalrows, double *totaldeadrows);
@@ -187,6 +256,11 @@ file_fdw_handler(PG_FUNCTION_ARGS)
 	fdwroutine->EndForeignScan = fileEndForeignScan;
 	fdwroutine->AnalyzeForeignTable = fileAnalyzeForeignTable;
 	fdwroutine->IsForeignScanParallelSafe = fileIsForeignScanParallelSafe;
+	fdwroutine->EstimateDSMForeignScan = fileEstimateDSMForeignScan;
+	fdwroutine->InitializeDSMForeignScan = fileInitializeDSMForeignScan;
+	fdwroutine->ReInitializeDSMForeignScan = fileReInitializeDSMForeignScan;
+	fdwroutine->InitializeWorkerForeignScan = fileInitializeWorkerForeignScan;
+	fdwroutine->ShutdownForeignScan = fileShutdownForeignScan;
 
 	PG_RETURN_POINTER(fdwroutine);
 }
@@ -542,7 +616,8 @@ fileGetForeignRelSize(PlannerInfo *root,
  *
  *		Currently we don't support any push-down feature, so there is only one
  *		possible access path, which simply returns all records in the order in
- *		the data file.
+ *		the data file.  If the file can be split between parallel workers, we
+ *		also add a partial path that does that.
  */
 static void
 fileGetForeignPaths(PlannerInfo *root,
@@ -563,7 +638,7 @@ fileGetForeignPaths(PlannerInfo *root,
 										  (Node *) columns, -1));
 
 	/* Estimate costs */
-	estimate_costs(root, baserel, fdw_private,
+	estimate_costs(root, baserel, fdw_private, 0,
 				   &startup_cost, &total_cost);
 
 	/*
@@ -588,6 +663,43 @@ fileGetForeignPaths(PlannerInfo *root,
 									 NIL,	/* no fdw_restrictinfo list */
 									 coptions));
 
+	/*
+	 * Consider a parallel scan.  Partial paths can't be parameterized, so
+	 * don't bother if there are LATERAL refs.
+	 */
+	if (baserel->consider_parallel && baserel->lateral_relids == NULL &&
+		file_is_splittable(fdw_private->filename, fdw_private->is_program,
+						   fdw_private->options))
+	{
+		int			parallel_workers;
+
+		parallel_workers = compute_parallel_worker(baserel, fdw_private->pages,
+												   -1,
+												   max_parallel_workers_per_gather);
+		if (parallel_workers > 0)
+		{
+			ForeignPath *path;
+
+			estimate_costs(root, baserel, fdw_private, parallel_workers,
+						   &startup_cost, &total_cost);
+			path = create_foreignscan_path(root, baserel,
+										   NULL,	/* default pathtarget */
+										   clamp_row_est(baserel->rows /
+														 file_parallel_divisor(parallel_workers)),
+										   0,
+										   startup_cost,
+										   total_cost,
+										   NIL, /* no pathkeys */
+										   NULL,	/* no outer rel either */
+										   NULL,	/* no extra plan */
+										   NIL, /* no fdw_restrictinfo list */
+										   coptions);
+			path->path.parallel_aware = true;
+			path->path.parallel_workers = parallel_workers;
+			add_partial_path(baserel, (Path *) path);
+		}
+	}
+
 	/*
 	 * If data file was sorted, and we knew it somehow, we could insert
 	 * appropriate pathkeys into the ForeignPath node to tell the planner
@@ -692,25 +804,32 @@ fileBeginForeignScan(ForeignScanState *node, int eflags)
 	/*
 	 * Create CopyState from FDW options.  We always acquire all columns, so
 	 * as to match the expected ScanTupleSlot signature.
+	 *
+	 * A parallel-aware scan doesn't know yet which parts of the file it's
+	 * going to read; it creates a CopyState for each of them as it goes.
 	 */
-	cstate = BeginCopyFrom(NULL,
-						   node->ss.ss_currentRelation,
-						   NULL,
-						   filename,
-						   is_program,
-						   NULL,
-						   NIL,
-						   options);
+	if (plan->scan.plan.parallel_aware)
+		cstate = NULL;
+	else
+		cstate = BeginCopyFrom(NULL,
+							   node->ss.ss_currentRelation,
+							   NULL,
+							   filename,
+							   is_program,
+							   NULL,
+							   NIL,
+							   options);
 
 	/*
 	 * Save state in node->fdw_state.  We must save enough information to call
 	 * BeginCopyFrom() again.
 	 */
-	festate = (FileFdwExecutionState *) palloc(sizeof(FileFdwExecutionState));
+	festate = (FileFdwExecutionState *) palloc0(sizeof(FileFdwExecutionState));
 	festate->filename = filename;
 	festate->is_program = is_program;
 	festate->options = options;
 	festate->cstate = cstate;
+	festate->fd = -1;
 
 	node->fdw_state = (void *) festate;
 }
@@ -728,9 +847,14 @@ fileIterateForeignScan(ForeignScanState *node)
 	ExprContext *econtext;
 	MemoryContext oldcontext = CurrentMemoryContext;
 	TupleTableSlot *slot = node->ss.ss_ScanTupleSlot;
-	CopyFromState cstate = festate->cstate;
+	CopyFromState cstate;
 	ErrorContextCallback errcallback;
 
+	/* In a parallel-aware scan, start reading the first chunk if needed. */
+	if (festate->cstate == NULL && !file_begin_next_chunk(node))
+		return ExecClearTuple(slot);
+	cstate = festate->cstate;
+
 	/* Set up callback to identify error line number. */
 	errcallback.callback = CopyFromErrorCallback;
 	errcallback.arg = (void *) cstate;
@@ -760,6 +884,7 @@ retry:
 	 */
 	ExecClearTuple(slot);
 
+	chunk_reader = festate;
 	if (NextCopyFrom(cstate, econtext, slot->tts_values, slot->tts_isnull))
 	{
 		if (cstate->opts.on_error == COPY_ON_ERROR_IGNORE &&
@@ -794,6 +919,20 @@ retry:
 
 		ExecStoreVirtualTuple(slot);
 	}
+	else if (festate->pstate != NULL)
+	{
+		/* End of chunk.  Move on to the next one, if there's any left. */
+		MemoryContextSwitchTo(oldcontext);
+		file_check_end_of_chunk(festate);
+		if (file_begin_next_chunk(node))
+		{
+			cstate = festate->cstate;
+			errcallback.arg = (void *) cstate;
+			ResetPerTupleExprContext(estate);
+			goto retry;
+		}
+		file_publish_num_errors(festate);
+	}
 
 	/* Switch back to original memory context */
 	MemoryContextSwitchTo(oldcontext);
@@ -813,7 +952,21 @@ fileReScanForeignScan(ForeignScanState *node)
 {
 	FileFdwExecutionState *festate = (FileFdwExecutionState *) node->fdw_state;
 
-	EndCopyFrom(festate->cstate);
+	if (festate->cstate)
+		EndCopyFrom(festate->cstate);
+
+	/*
+	 * A parallel-aware scan starts over by claiming chunks again; if running
+	 * in parallel, the leader has reset the shared state.
+	 */
+	if (node->ss.ps.plan->parallel_aware)
+	{
+		festate->cstate = NULL;
+		festate->num_errors = 0;
+		festate->errors_published = false;
+		festate->errors_reported = false;
+		return;
+	}
 
 	festate->cstate = BeginCopyFrom(NULL,
 									node->ss.ss_currentRelation,
@@ -838,18 +991,67 @@ fileEndForeignScan(ForeignScanState *node)
 	if (!festate)
 		return;
 
-	if (festate->cstate->opts.on_error == COPY_ON_ERROR_IGNORE &&
-		festate->cstate->num_errors > 0 &&
+	if (festate->fd >= 0)
+		CloseTransientFile(festate->fd);
+
+	/* cstate is NULL if a parallel-aware scan didn't get to read anything */
+	if (!festate->cstate)
+		return;
+
+	/*
+	 * In a parallel scan, the leader has already reported the rows skipped by
+	 * all participants in fileShutdownForeignScan.
+	 */
+	festate->num_errors += festate->cstate->num_errors;
+	if (festate->pstate == NULL &&
+		festate->cstate->opts.on_error == COPY_ON_ERROR_IGNORE &&
+		festate->num_errors > 0 &&
 		festate->cstate->opts.log_verbosity >= COPY_LOG_VERBOSITY_DEFAULT)
 		ereport(NOTICE,
 				errmsg_plural("%llu row was skipped due to data type incompatibility",
 							  "%llu rows were skipped due to data type incompatibility",
-							  (unsigned long long) festate->cstate->num_errors,
-							  (unsigned long long) festate->cstate->num_errors));
+							  (unsigned long long) festate->num_errors,
+							  (unsigned long long) festate->num_errors));
 
 	EndCopyFrom(festate->cstate);
 }
 
+/*
+ * fileShutdownForeignScan
+ *		Report the rows skipped by all participants of a parallel scan
+ *
+ * This is called in the leader before the shared state goes away.  By then,
+ * every worker that has finished reading has added the rows it skipped to
+ * the shared count.
+ */
+static void
+fileShutdownForeignScan(ForeignScanState *node)
+{
+	FileFdwExecutionState *festate = (FileFdwExecutionState *) node->fdw_state;
+	CopyFormatOptions opts = {0};
+	uint64		num_errors;
+
+	if (!festate || !festate->pstate || IsParallelWorker() ||
+		festate->errors_reported)
+		return;
+
+	file_publish_num_errors(festate);
+	festate->errors_reported = true;
+
+	num_errors = pg_atomic_read_u64(&festate->pstate->num_errors);
+	if (num_errors == 0)
+		return;
+
+	ProcessCopyOptions(NULL, &opts, true, festate->options);
+	if (opts.on_error == COPY_ON_ERROR_IGNORE &&
+		opts.log_verbosity >= COPY_LOG_VERBOSITY_DEFAULT)
+		ereport(NOTICE,
+				errmsg_plural("%llu row was skipped due to data type incompatibility",
+							  "%llu rows were skipped due to data type incompatibility",
+							  (unsigned long long) num_errors,
+							  (unsigned long long) num_errors));
+}
+
 /*
  * fileAnalyzeForeignTable
  *		Test whether analyzing this foreign table is supported
@@ -902,14 +1104,75 @@ fileAnalyzeForeignTable(Relation relation,
 
 /*
  * fileIsForeignScanParallelSafe
- *		Reading a file, or external program, in a parallel worker should work
- *		just the same as reading it in the leader, so mark scans safe.
+ *		Reading a regular file in a parallel worker works just the same as
+ *		reading it in the leader.  But a non-partial scan under a Gather may
+ *		be run by every participant, so a program would be executed several
+ *		times, and the participants would split the data of a pipe or device
+ *		between them.  Scans of those must stay in the leader.
  */
 static bool
 fileIsForeignScanParallelSafe(PlannerInfo *root, RelOptInfo *rel,
 							  RangeTblEntry *rte)
 {
-	return true;
+	char	   *filename;
+	bool		is_program;
+	List	   *options;
+
+	fileGetOptions(rte->relid, &filename, &is_program, &options);
+
+	return !is_program && file_is_regular_file(filename);
+}
+
+/*
+ * fileEstimateDSMForeignScan
+ *		Estimate the size of the shared state of a parallel scan
+ */
+static Size
+fileEstimateDSMForeignScan(ForeignScanState *node, ParallelContext *pcxt)
+{
+	return sizeof(FileFdwParallelState);
+}
+
+/*
+ * fileInitializeDSMForeignScan
+ *		Set up the shared state of a parallel scan
+ */
+static void
+fileInitializeDSMForeignScan(ForeignScanState *node, ParallelContext *pcxt,
+							 void *coordinate)
+{
+	FileFdwExecutionState *festate = (FileFdwExecutionState *) node->fdw_state;
+	FileFdwParallelState *pstate = (FileFdwParallelState *) coordinate;
+
+	file_init_parallel_state(festate, pstate);
+	festate->pstate = pstate;
+}
+
+/*
+ * fileReInitializeDSMForeignScan
+ *		Reset the shared state of a parallel scan before a rescan
+ */
+static void
+fileReInitializeDSMForeignScan(ForeignScanState *node, ParallelContext *pcxt,
+							   void *coordinate)
+{
+	FileFdwExecutionState *festate = (FileFdwExecutionState *) node->fdw_state;
+	FileFdwParallelState *pstate = (FileFdwParallelState *) coordinate;
+
+	file_init_parallel_state(festate, pstate);
+}
+
+/*
+ * fileInitializeWorkerForeignScan
+ *		Attach a parallel worker to the shared state of a parallel scan
+ */
+static void
+fileInitializeWorkerForeignScan(ForeignScanState *node, shm_toc *toc,
+								void *coordinate)
+{
+	FileFdwExecutionState *festate = (FileFdwExecutionState *) node->fdw_state;
+
+	festate->pstate = (FileFdwParallelState *) coordinate;
 }
 
 /*
@@ -1125,17 +1388,21 @@ estimate_size(PlannerInfo *root, RelOptInfo *baserel,
 /*
  * Estimate costs of scanning a foreign table.
  *
+ * If parallel_workers > 0, estimate the costs of each participant of a
+ * parallel scan using that many workers.
+ *
  * Results are returned in *startup_cost and *total_cost.
  */
 static void
 estimate_costs(PlannerInfo *root, RelOptInfo *baserel,
-			   FileFdwPlanState *fdw_private,
+			   FileFdwPlanState *fdw_private, int parallel_workers,
 			   Cost *startup_cost, Cost *total_cost)
 {
 	BlockNumber pages = fdw_private->pages;
 	double		ntuples = fdw_private->ntuples;
 	Cost		run_cost = 0;
 	Cost		cpu_per_tuple;
+	Cost		cpu_run_cost;
 
 	/*
 	 * We estimate costs almost the same way as cost_seqscan(), thus assuming
@@ -1152,10 +1419,411 @@ estimate_costs(PlannerInfo *root, RelOptInfo *baserel,
 
 	*startup_cost = baserel->baserestrictcost.startup;
 	cpu_per_tuple = cpu_tuple_cost * 10 + baserel->baserestrictcost.per_tuple;
-	run_cost += cpu_per_tuple * ntuples;
+	cpu_run_cost = cpu_per_tuple * ntuples;
+
+	/*
+	 * As in cost_seqscan(), parsing is divided among the participants of a
+	 * parallel scan, but I/O is not.
+	 */
+	if (parallel_workers > 0)
+		cpu_run_cost /= file_parallel_divisor(parallel_workers);
+
+	run_cost += cpu_run_cost;
 	*total_cost = *startup_cost + run_cost;
 }
 
+/*
+ * Estimate the fraction of the work of a parallel scan that each participant
+ * does.  This is the same as get_parallel_divisor() in costsize.c.
+ */
+static double
+file_parallel_divisor(int parallel_workers)
+{
+	double		parallel_divisor = parallel_workers;
+
+	if (parallel_leader_participation)
+	{
+		double		leader_contribution;
+
+		leader_contribution = 1.0 - (0.3 * parallel_workers);
+		if (leader_contribution > 0)
+			parallel_divisor += leader_contribution;
+	}
+
+	return parallel_divisor;
+}
+
+/*
+ * Check whether a file exists and is a regular file.  The size of anything
+ * else, such as a pipe or device, doesn't tell how much data it holds.
+ */
+static bool
+file_is_regular_file(const char *filename)
+{
+	struct stat stat_buf;
+
+	return stat(filename, &stat_buf) == 0 && S_ISREG(stat_buf.st_mode);
+}
+
+/*
+ * Check whether a data source can be split into ranges of lines to be read
+ * by parallel workers.
+ *
+ * That requires a regular file, not a program, in text format, where every newline
+ * that isn't escaped with a backslash ends a row.  (In CSV format, newlines
+ * can also appear inside quoted fields, which we can't recognize without
+ * reading the file from the start.)  We also insist on an encoding that
+ * doesn't allow backslashes in multibyte characters, so that we can tell
+ * escaped newlines apart by looking at the preceding bytes only.
+ */
+static bool
+file_is_splittable(const char *filename, bool is_program, List *options)
+{
+	int			file_encoding = pg_get_client_encoding();
+	ListCell   *lc;
+
+	if (is_program || !file_is_regular_file(filename))
+		return false;
+
+	foreach(lc, options)
+	{
+		DefElem    *def = (DefElem *) lfirst(lc);
+
+		if (strcmp(def->defname, "format") == 0)
+		{
+			if (strcmp(defGetString(def), "text") != 0)
+				return false;
+		}
+		else if (strcmp(def->defname, "encoding") == 0)
+			file_encoding = pg_char_to_encoding(defGetString(def));
+	}
+
+	return !PG_ENCODING_IS_CLIENT_ONLY(file_encoding);
+}
+
+/*
+ * Set up the shared state of a parallel scan to start from the beginning
+ * of the file.
+ */
+static void
+file_init_parallel_state(FileFdwExecutionState *festate,
+						 FileFdwParallelState *pstate)
+{
+	struct stat stat_buf;
+
+	if (stat(festate->filename, &stat_buf) < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not stat file \"%s\": %m",
+						festate->filename)));
+
+	pstate->file_size = stat_buf.st_size;
+	pstate->chunk_size = FILE_FDW_CHUNK_SIZE;
+
+	/*
+	 * The plan might have been made under a different client_encoding, or
+	 * the file replaced by a pipe since, so check again.  If the file can't
+	 * be split after all, only one participant reads it, up to EOF.
+	 */
+	pstate->whole_file = !file_is_splittable(festate->filename,
+											 festate->is_program,
+											 festate->options);
+
+	pg_atomic_init_u64(&pstate->next_offset, 0);
+	pg_atomic_init_u64(&pstate->num_errors, 0);
+}
+
+/*
+ * Set up festate->cstate to read the next part of the file, ending the
+ * previous CopyState if any.  Returns false if there's nothing left for this
+ * participant to read, in which case the previous CopyState is left alone.
+ *
+ * Without shared state, a parallel-aware scan is not running in parallel
+ * after all, and reads the whole file at once.  The same goes for the one
+ * participant that gets to read a file that can't be split.
+ */
+static bool
+file_begin_next_chunk(ForeignScanState *node)
+{
+	FileFdwExecutionState *festate = (FileFdwExecutionState *) node->fdw_state;
+	FileFdwParallelState *pstate = festate->pstate;
+	List	   *options = festate->options;
+	MemoryContext oldcontext;
+
+	if (pstate == NULL || pstate->whole_file)
+	{
+		if (festate->cstate != NULL)
+			return false;
+
+		/* With shared state, only the first participant to get here reads */
+		if (pstate != NULL &&
+			pg_atomic_fetch_add_u64(&pstate->next_offset, 1) > 0)
+			return false;
+
+		oldcontext = MemoryContextSwitchTo(node->ss.ps.state->es_query_cxt);
+		festate->cstate = BeginCopyFrom(NULL,
+										node->ss.ss_currentRelation,
+										NULL,
+										festate->filename,
+										festate->is_program,
+										NULL,
+										NIL,
+										options);
+		MemoryContextSwitchTo(oldcontext);
+		return true;
+	}
+
+	/*
+	 * Claim chunks until we get one that contains the start of a line.  The
+	 * last chunk extends up to EOF, in case the file has grown since the scan
+	 * began.
+	 */
+	for (;;)
+	{
+		uint64		start;
+		uint64		end;
+
+		start = pg_atomic_fetch_add_u64(&pstate->next_offset,
+										pstate->chunk_size);
+		if (start >= pstate->file_size)
+			return false;
+		end = start + pstate->chunk_size;
+
+		if (festate->fd < 0)
+		{
+			festate->fd = OpenTransientFile(festate->filename,
+											O_RDONLY | PG_BINARY);
+			if (festate->fd < 0)
+				ereport(ERROR,
+						(errcode_for_file_access(),
+						 errmsg("could not open file \"%s\" for reading: %m",
+								festate->filename)));
+		}
+
+		festate->chunk_pos = file_line_start(festate, start);
+		if (end >= pstate->file_size)
+			festate->chunk_end = -1;
+		else
+		{
+			festate->chunk_end = file_line_start(festate, end);
+			if (festate->chunk_pos >= festate->chunk_end)
+				continue;
+		}
+		break;
+	}
+
+	oldcontext = MemoryContextSwitchTo(node->ss.ps.state->es_query_cxt);
+
+	/* Only the first line of the file can be a header line. */
+	if (festate->chunk_pos > 0)
+	{
+		ListCell   *lc;
+
+		options = list_copy(options);
+		foreach(lc, options)
+		{
+			DefElem    *def = (DefElem *) lfirst(lc);
+
+			if (strcmp(def->defname, "header") == 0)
+				options = foreach_delete_current(options, lc);
+		}
+	}
+
+	if (festate->cstate != NULL)
+	{
+		festate->num_errors += festate->cstate->num_errors;
+		EndCopyFrom(festate->cstate);
+	}
+
+	chunk_reader = festate;
+	festate->cstate = BeginCopyFrom(NULL,
+									node->ss.ss_currentRelation,
+									NULL,
+									NULL,
+									false,
+									file_read_chunk,
+									NIL,
+									options);
+	MemoryContextSwitchTo(oldcontext);
+
+	return true;
+}
+
+/*
+ * Check that the CopyState of the current chunk stopped reading because it
+ * ran out of data, rather than at an end-of-data marker (\.) with more data
+ * following it in the file.
+ *
+ * A serial scan stops at the marker, but in a parallel scan the other
+ * participants would go on to read the chunks after it, so the result would
+ * depend on the plan.  We can't tell in advance whether a file contains a
+ * marker, so throw an error instead.
+ */
+static void
+file_check_end_of_chunk(FileFdwExecutionState *festate)
+{
+	CopyFromState cstate = festate->cstate;
+	int			unread;
+	bool		more_data;
+
+	/* A participant reading the whole file stops there, like a serial scan */
+	if (festate->pstate->whole_file)
+		return;
+
+	/* Data that COPY has read from the file but not parsed */
+	if (cstate->need_transcoding)
+		unread = INPUT_BUF_BYTES(cstate) + RAW_BUF_BYTES(cstate);
+	else
+		unread = cstate->raw_buf_len - cstate->input_buf_index;
+
+	if (cstate->input_reached_eof && unread == 0)
+		return;
+
+	/* COPY stopped at an end-of-data marker; does anything follow it? */
+	if (unread > 0)
+		more_data = true;
+	else if (festate->chunk_end >= 0)
+		more_data = festate->chunk_pos < festate->chunk_end ||
+			(uint64) festate->chunk_end < festate->pstate->file_size;
+	else
+	{
+		char		c;
+
+		more_data = file_pread(festate, &c, 1, festate->chunk_pos) > 0;
+	}
+
+	if (more_data)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("end-of-copy marker found in the middle of file \"%s\" during a parallel scan",
+						festate->filename),
+				 errhint("Remove the data following the marker, or set \"%s\" to 0 to read the file without a parallel scan.",
+						 "max_parallel_workers_per_gather")));
+}
+
+/*
+ * Add the rows this participant skipped due to on_error = ignore to the
+ * shared count, once it has finished reading its part of the file.
+ */
+static void
+file_publish_num_errors(FileFdwExecutionState *festate)
+{
+	uint64		num_errors = festate->num_errors;
+
+	if (festate->errors_published)
+		return;
+
+	if (festate->cstate)
+		num_errors += festate->cstate->num_errors;
+	pg_atomic_fetch_add_u64(&festate->pstate->num_errors, num_errors);
+	festate->errors_published = true;
+}
+
+/*
+ * Find the first line of the file that begins at or after 'offset'.  Returns
+ * the file size if there is none.
+ *
+ * A line begins after a newline, unless the newline is escaped by a
+ * backslash, i.e., preceded by an odd number of backslashes.
+ */
+static off_t
+file_line_start(FileFdwExecutionState *festate, off_t offset)
+{
+	char		buf[8192];
+	off_t		pos;
+
+	if (offset == 0)
+		return 0;
+
+	/* The line could begin right at 'offset', so look at the byte before */
+	pos = offset - 1;
+	for (;;)
+	{
+		int			nread;
+
+		nread = file_pread(festate, buf, sizeof(buf), pos);
+		if (nread == 0)
+			return pos;
+
+		for (int i = 0; i < nread; i++)
+		{
+			off_t		backslash_pos;
+			int			nbackslashes = 0;
+
+			if (buf[i] != '\n')
+				continue;
+
+			/* Count the backslashes before the newline */
+			for (backslash_pos = pos + i - 1; backslash_pos >= 0; backslash_pos--)
+			{
+				char		c;
+
+				if (backslash_pos >= pos)
+					c = buf[backslash_pos - pos];
+				else if (file_pread(festate, &c, 1, backslash_pos) != 1)
+					break;
+				if (c != '\\')
+					break;
+				nbackslashes++;
+			}
+
+			if (nbackslashes % 2 == 0)
+				return pos + i + 1;
+		}
+		pos += nread;
+	}
+}
+
+/*
+ * COPY data source callback, to read the current chunk of chunk_reader.
+ */
+static int
+file_read_chunk(void *outbuf, int minread, int maxread)
+{
+	FileFdwExecutionState *festate = chunk_reader;
+	int			bytesread = 0;
+
+	while (bytesread < minread)
+	{
+		size_t		nbytes = maxread - bytesread;
+		int			nread;
+
+		if (festate->chunk_end >= 0)
+			nbytes = Min(nbytes,
+						 (size_t) (festate->chunk_end - festate->chunk_pos));
+		if (nbytes == 0)
+			break;
+
+		nread = file_pread(festate, (char *) outbuf + bytesread, nbytes,
+						   festate->chunk_pos);
+		if (nread == 0)
+			break;
+		festate->chunk_pos += nread;
+		bytesread += nread;
+	}
+
+	return bytesread;
+}
+
+/*
+ * Read from the file of a parallel-aware scan, erroring out on failure.
+ */
+static int
+file_pread(FileFdwExecutionState *festate, void *buf, size_t nbytes,
+		   off_t offset)
+{
+	ssize_t		nread;
+
+	nread = pg_pread(festate->fd, buf, nbytes, offset);
+	if (nread < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not read file \"%s\": %m",
+						festate->filename)));
+
+	return (int) nread;
+}
+
 /*
  * file_acquire_sample_rows -- acquire a random sample of rows from the table
  *
@@ -4,6 +4,7 @@
 
 -- directory paths are passed to us in environment variables
 \getenv abs_srcdir PG_ABS_SRCDIR
+\getenv abs_builddir PG_ABS_BUILDDIR
 
 -- Clean up in case a prior regression run failed
 SET client_min_messages TO 'warning';
@@ -194,6 +195,83 @@ SELECT explain_filter('EXPLAIN (VERBOSE, COSTS FALSE) SELECT * FROM agg_csv WHER
 SELECT * FROM agg_csv WHERE a < 0;
 RESET constraint_exclusion;
 
+-- parallel scan tests
+SET parallel_setup_cost = 0;
+SET parallel_tuple_cost = 0;
+SET min_parallel_table_scan_size = 0;
+\t on
+SELECT explain_filter('EXPLAIN (COSTS FALSE) SELECT count(*), sum(a) FROM agg_text');
+SELECT explain_filter('EXPLAIN (COSTS FALSE) SELECT count(*), sum(a) FROM agg_csv');
+\t off
+SELECT count(*), sum(a) FROM agg_text;
+
+-- a file spanning several chunks, with a header line, a line longer than a
+-- chunk, and escaped newlines where the chunk boundaries fall
+\set filename :abs_builddir '/results/parallel.data'
+CREATE TEMP TABLE parallel_lo AS
+  SELECT lo_from_bytea(0, convert_to(
+    E'a\tb\n' ||
+    (SELECT string_agg(lpad(i::text, 6, '0') || E'\tx\\\nx\\\nx\\\nz\\\\\n', '')
+       FROM generate_series(1, 120000) i) ||
+    E'120001\t' || repeat(E'x\\\n', 750000) || E'z\\\\\n' ||
+    (SELECT string_agg(lpad(i::text, 6, '0') || E'\tx\\\nx\\\nx\\\nz\\\\\n', '')
+       FROM generate_series(120002, 121001) i),
+    'UTF8')) AS loid;
+SELECT lo_export(loid, :'filename') FROM parallel_lo;
+SELECT lo_unlink(loid) FROM parallel_lo;
+CREATE FOREIGN TABLE big_text (a int, b text) SERVER file_server
+OPTIONS (format 'text', filename :'filename', header 'true');
+CREATE FOREIGN TABLE big_text_int2 (a int2, b text) SERVER file_server
+OPTIONS (format 'text', filename :'filename', header 'true', on_error 'ignore');
+\t on
+SELECT explain_filter('EXPLAIN (COSTS FALSE) SELECT count(*), sum(a), sum(length(b)) FROM big_text');
+\t off
+SELECT count(*), sum(a), sum(length(b)) FROM big_text;
+-- rows skipped by all participants are reported once
+SELECT count(*), sum(a) FROM big_text_int2;
+SET max_parallel_workers_per_gather = 0;
+SELECT count(*), sum(a), sum(length(b)) FROM big_text;
+SELECT count(*), sum(a) FROM big_text_int2;
+RESET max_parallel_workers_per_gather;
+
+-- an end-of-data marker followed by more data can't be handled in parallel
+\set filename :abs_builddir '/results/parallel_marker.data'
+TRUNCATE parallel_lo;
+INSERT INTO parallel_lo
+  SELECT lo_from_bytea(0, convert_to(
+    E'1\tbefore\n\\.\n' ||
+    (SELECT string_agg(i::text || E'\tafter marker\n', '')
+       FROM generate_series(2, 100000) i),
+    'UTF8'));
+SELECT lo_export(loid, :'filename') FROM parallel_lo;
+SELECT lo_unlink(loid) FROM parallel_lo;
+DROP TABLE parallel_lo;
+CREATE FOREIGN TABLE marker_text (a int, b text) SERVER file_server
+OPTIONS (format 'text', filename :'filename');
+DO $$
+BEGIN
+  PERFORM count(*) FROM marker_text;
+EXCEPTION WHEN feature_not_supported THEN
+  RAISE NOTICE 'parallel scan rejected end-of-copy marker';
+END
+$$;
+SET max_parallel_workers_per_gather = 0;
+SELECT count(*) FROM marker_text;
+RESET max_parallel_workers_per_gather;
+-- a program must not be run by parallel workers, unlike a regular file
+CREATE FOREIGN TABLE program_text (a int) SERVER file_server
+OPTIONS (format 'text', program 'echo 1');
+SET debug_parallel_query = on;
+\t on
+SELECT explain_filter('EXPLAIN (COSTS FALSE) SELECT * FROM agg_csv');
+SELECT explain_filter('EXPLAIN (COSTS FALSE) SELECT * FROM program_text');
+\t off
+RESET debug_parallel_query;
+DROP FOREIGN TABLE big_text, big_text_int2, marker_text, program_text;
+RESET parallel_setup_cost;
+RESET parallel_tuple_cost;
+RESET min_parallel_table_scan_size;
+
 -- table inheritance tests
 CREATE TABLE agg (a int2, b float4);
 ALTER FOREIGN TABLE agg_csv INHERIT agg;
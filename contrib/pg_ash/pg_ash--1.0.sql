@@ -0,0 +1,61 @@
+/* contrib/pg_ash/pg_ash--1.0.sql */
+
+-- complain if script is sourced in psql, rather than via CREATE EXTENSION
+\echo Use "CREATE EXTENSION pg_ash" to load this file. \quit
+
+-- Register functions.
+CREATE FUNCTION pg_ash_history(
+    OUT sample_time timestamptz,
+    OUT pid int4,
+    OUT backend_type text,
+    OUT datid oid,
+    OUT usesysid oid,
+    OUT state text,
+    OUT wait_event_type text,
+    OUT wait_event text,
+    OUT query_id int8
+)
+RETURNS SETOF record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT VOLATILE PARALLEL SAFE;
+
+CREATE FUNCTION pg_ash_reset()
+RETURNS void
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT PARALLEL SAFE;
+
+-- Register a view on the function for ease of use.
+CREATE VIEW pg_ash AS
+  SELECT * FROM pg_ash_history();
+
+-- Share of sampled activity per wait event over a recent time window.  A
+-- session that was active but not waiting is reported as running on CPU.
+CREATE FUNCTION pg_ash_wait_summary(
+    IN lookback interval DEFAULT '5 minutes',
+    OUT wait_event_type text,
+    OUT wait_event text,
+    OUT samples int8,
+    OUT pct numeric
+)
+RETURNS SETOF record
+LANGUAGE sql STRICT VOLATILE PARALLEL SAFE
+BEGIN ATOMIC
+  SELECT coalesce(h.wait_event_type, 'CPU'),
+         h.wait_event,
+         count(*),
+         round(100.0 * count(*) / sum(count(*)) OVER (), 2)
+    FROM pg_ash_history() h
+    WHERE h.sample_time >= now() - lookback
+    GROUP BY 1, 2
+    ORDER BY 3 DESC, 1, 2;
+END;
+
+-- Don't want these to be available to non-superusers.
+REVOKE ALL ON FUNCTION pg_ash_history() FROM PUBLIC;
+REVOKE ALL ON FUNCTION pg_ash_reset() FROM PUBLIC;
+REVOKE ALL ON FUNCTION pg_ash_wait_summary(interval) FROM PUBLIC;
+REVOKE ALL ON pg_ash FROM PUBLIC;
+
+GRANT EXECUTE ON FUNCTION pg_ash_history() TO pg_read_all_stats;
+GRANT EXECUTE ON FUNCTION pg_ash_wait_summary(interval) TO pg_read_all_stats;
+GRANT SELECT ON pg_ash TO pg_read_all_stats;
@@ -0,0 +1,483 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_ash.c
+ *		Sampled active session history.
+ *
+ * A background worker periodically looks at what every backend is doing
+ * and, for each session that is active at that moment, records its wait
+ * event (or the fact that it's running on CPU), state, and query ID into a
+ * fixed-size ring buffer in shared memory.  Aggregating the samples over a
+ * time window gives a statistical picture of where the server spends its
+ * time, something the instantaneous view in pg_stat_activity can't provide
+ * without polling it from the outside at a high frequency.
+ *
+ * Each sample only copies a handful of fixed-size fields out of the shared
+ * backend status array, so the cost per tick is proportional to the number
+ * of backend slots and doesn't depend on the length of the queries being
+ * run.  The history is not preserved across server restarts.
+ *
+ * Copyright (c) 2024, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  contrib/pg_ash/pg_ash.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "fmgr.h"
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "postmaster/bgworker.h"
+#include "postmaster/interrupt.h"
+#include "storage/ipc.h"
+#include "storage/latch.h"
+#include "storage/lwlock.h"
+#include "storage/proc.h"
+#include "storage/procsignal.h"
+#include "storage/shmem.h"
+#include "utils/backend_status.h"
+#include "utils/builtins.h"
+#include "utils/guc.h"
+#include "utils/timestamp.h"
+#include "utils/wait_event.h"
+
+PG_MODULE_MAGIC;
+
+/*
+ * One observation of one active session.
+ */
+typedef struct AshSample
+{
+	TimestampTz sample_time;
+	int			pid;
+	BackendType backend_type;
+	Oid			datid;
+	Oid			userid;
+	BackendState state;
+	uint32		wait_event_info;
+	uint64		query_id;
+} AshSample;
+
+/*
+ * Shared state.  Samples are stored in a ring; "next" is the total number of
+ * samples ever written since the last reset, so the slot for the next one is
+ * next % max_samples and the ring is full once next >= max_samples.
+ */
+typedef struct AshSharedState
+{
+	LWLock	   *lock;			/* protects the fields below */
+	uint64		next;
+	AshSample	samples[FLEXIBLE_ARRAY_MEMBER];
+} AshSharedState;
+
+/* Saved hook values */
+static shmem_request_hook_type prev_shmem_request_hook = NULL;
+static shmem_startup_hook_type prev_shmem_startup_hook = NULL;
+
+/* Links to shared memory state */
+static AshSharedState *ash = NULL;
+
+/* GUC variables */
+static int	ash_sample_interval = 10;	/* ms between samples */
+static int	ash_max_samples = 100000;	/* size of the ring */
+
+PG_FUNCTION_INFO_V1(pg_ash_history);
+PG_FUNCTION_INFO_V1(pg_ash_reset);
+
+PGDLLEXPORT void pg_ash_main(Datum main_arg);
+
+static void ash_shmem_request(void);
+static void ash_shmem_startup(void);
+static Size ash_memsize(void);
+static int	ash_collect(AshSample *buf, int nslots);
+static bool ash_sample_is_active(const PgBackendSample *sample);
+
+
+/*
+ * Module load callback
+ */
+void
+_PG_init(void)
+{
+	BackgroundWorker worker;
+
+	/*
+	 * In order to create our shared memory area and register the sampling
+	 * worker, we have to be loaded via shared_preload_libraries.  If not,
+	 * fall out without hooking into any of the main system.  (We don't throw
+	 * error here because it seems useful to allow the pg_ash functions to be
+	 * created even when the module isn't active.  The functions must protect
+	 * themselves against being called then, however.)
+	 */
+	if (!process_shared_preload_libraries_in_progress)
+		return;
+
+	/*
+	 * Define (or redefine) custom GUC variables.
+	 */
+	DefineCustomIntVariable("pg_ash.sample_interval",
+							"Sets the interval between samples of active sessions.",
+							NULL,
+							&ash_sample_interval,
+							10,
+							1,
+							INT_MAX / 1000,
+							PGC_SIGHUP,
+							GUC_UNIT_MS,
+							NULL,
+							NULL,
+							NULL);
+
+	DefineCustomIntVariable("pg_ash.max_samples",
+							"Sets the maximum number of samples kept by pg_ash.",
+							NULL,
+							&ash_max_samples,
+							100000,
+							1000,
+							INT_MAX / 2,
+							PGC_POSTMASTER,
+							0,
+							NULL,
+							NULL,
+							NULL);
+
+	MarkGUCPrefixReserved("pg_ash");
+
+	/*
+	 * Install hooks.
+	 */
+	prev_shmem_request_hook = shmem_request_hook;
+	shmem_request_hook = ash_shmem_request;
+	prev_shmem_startup_hook = shmem_startup_hook;
+	shmem_startup_hook = ash_shmem_startup;
+
+	/*
+	 * Register the sampling worker.
+	 */
+	memset(&worker, 0, sizeof(BackgroundWorker));
+	worker.bgw_flags = BGWORKER_SHMEM_ACCESS;
+	worker.bgw_start_time = BgWorkerStart_PostmasterStart;
+	worker.bgw_restart_time = 10;
+	strcpy(worker.bgw_library_name, "pg_ash");
+	strcpy(worker.bgw_function_name, "pg_ash_main");
+	strcpy(worker.bgw_name, "pg_ash sampler");
+	strcpy(worker.bgw_type, "pg_ash sampler");
+
+	RegisterBackgroundWorker(&worker);
+}
+
+/*
+ * Estimate shared memory space needed.
+ */
+static Size
+ash_memsize(void)
+{
+	return add_size(offsetof(AshSharedState, samples),
+					mul_size(ash_max_samples, sizeof(AshSample)));
+}
+
+/*
+ * shmem_request hook: request additional shared resources.  We'll allocate
+ * or attach to the shared resources in ash_shmem_startup().
+ */
+static void
+ash_shmem_request(void)
+{
+	if (prev_shmem_request_hook)
+		prev_shmem_request_hook();
+
+	RequestAddinShmemSpace(ash_memsize());
+	RequestNamedLWLockTranche("pg_ash", 1);
+}
+
+/*
+ * shmem_startup hook: allocate or attach to shared memory.
+ */
+static void
+ash_shmem_startup(void)
+{
+	bool		found;
+
+	if (prev_shmem_startup_hook)
+		prev_shmem_startup_hook();
+
+	/* reset in case this is a restart within the postmaster */
+	ash = NULL;
+
+	LWLockAcquire(AddinShmemInitLock, LW_EXCLUSIVE);
+
+	ash = ShmemInitStruct("pg_ash", ash_memsize(), &found);
+
+	if (!found)
+	{
+		/* First time through ... */
+		ash->lock = &(GetNamedLWLockTranche("pg_ash"))->lock;
+		ash->next = 0;
+	}
+
+	LWLockRelease(AddinShmemInitLock);
+}
+
+/*
+ * Main entry point for the sampling worker.
+ */
+void
+pg_ash_main(Datum main_arg)
+{
+	int			nslots = MaxBackends + NUM_AUXILIARY_PROCS;
+	AshSample  *buf;
+
+	/* Establish signal handlers; once that's done, unblock signals. */
+	pqsignal(SIGTERM, SignalHandlerForShutdownRequest);
+	pqsignal(SIGHUP, SignalHandlerForConfigReload);
+	pqsignal(SIGUSR1, procsignal_sigusr1_handler);
+	BackgroundWorkerUnblockSignals();
+
+	/* Local buffer for one round, so we hold the lock only while copying. */
+	buf = palloc_extended(mul_size(sizeof(AshSample), nslots),
+						  MCXT_ALLOC_HUGE);
+
+	while (!ShutdownRequestPending)
+	{
+		TimestampTz start;
+		long		delay_in_ms;
+		int			n;
+
+		/* In case of a SIGHUP, just reload the configuration. */
+		if (ConfigReloadPending)
+		{
+			ConfigReloadPending = false;
+			ProcessConfigFile(PGC_SIGHUP);
+		}
+
+		start = GetCurrentTimestamp();
+		n = ash_collect(buf, nslots);
+
+		if (n > 0)
+		{
+			LWLockAcquire(ash->lock, LW_EXCLUSIVE);
+			for (int i = 0; i < n; i++)
+			{
+				ash->samples[ash->next % ash_max_samples] = buf[i];
+				ash->next++;
+			}
+			LWLockRelease(ash->lock);
+		}
+
+		/* Sleep until the next sample is due. */
+		delay_in_ms =
+			TimestampDifferenceMilliseconds(GetCurrentTimestamp(),
+											TimestampTzPlusMilliseconds(start,
+																		ash_sample_interval));
+		if (delay_in_ms > 0)
+			(void) WaitLatch(MyLatch,
+							 WL_LATCH_SET | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+							 delay_in_ms,
+							 PG_WAIT_EXTENSION);
+
+		/* Reset the latch, loop. */
+		ResetLatch(MyLatch);
+		CHECK_FOR_INTERRUPTS();
+	}
+}
+
+/*
+ * Take one sample of all active sessions into buf, returning the number of
+ * entries filled.  All of them get the same timestamp.
+ */
+static int
+ash_collect(AshSample *buf, int nslots)
+{
+	TimestampTz now = GetCurrentTimestamp();
+	int			n = 0;
+
+	for (ProcNumber procNumber = 0; procNumber < nslots; procNumber++)
+	{
+		PgBackendSample sample;
+		AshSample  *entry;
+
+		if (procNumber == MyProcNumber)
+			continue;
+		if (!pgstat_get_backend_sample(procNumber, &sample))
+			continue;
+		if (!ash_sample_is_active(&sample))
+			continue;
+
+		entry = &buf[n++];
+		entry->sample_time = now;
+		entry->pid = sample.pid;
+		entry->backend_type = sample.backendType;
+		entry->datid = sample.databaseid;
+		entry->userid = sample.userid;
+		entry->state = sample.state;
+		entry->wait_event_info = sample.wait_event_info;
+		entry->query_id = sample.query_id;
+	}
+
+	return n;
+}
+
+/*
+ * Is the process doing something worth recording?
+ *
+ * Client backends count while they're running a statement.  Other processes
+ * don't report a state, so for them any wait outside of their main loop's
+ * idle wait, as well as running on CPU, is counted.
+ */
+static bool
+ash_sample_is_active(const PgBackendSample *sample)
+{
+	switch (sample->state)
+	{
+		case STATE_RUNNING:
+		case STATE_FASTPATH:
+			return true;
+		case STATE_UNDEFINED:
+			return (sample->wait_event_info & 0xFF000000) != PG_WAIT_ACTIVITY;
+		default:
+			return false;
+	}
+}
+
+/*
+ * Text representation of a backend state, as used in pg_stat_activity.
+ */
+static const char *
+ash_state_name(BackendState state)
+{
+	switch (state)
+	{
+		case STATE_IDLE:
+			return "idle";
+		case STATE_RUNNING:
+			return "active";
+		case STATE_IDLEINTRANSACTION:
+			return "idle in transaction";
+		case STATE_FASTPATH:
+			return "fastpath function call";
+		case STATE_IDLEINTRANSACTION_ABORTED:
+			return "idle in transaction (aborted)";
+		case STATE_DISABLED:
+			return "disabled";
+		case STATE_UNDEFINED:
+			break;
+	}
+	return NULL;
+}
+
+/* Number of output arguments (columns) for pg_ash_history */
+#define PG_ASH_HISTORY_COLS		9
+
+/*
+ * Retrieve the sample history, oldest first.
+ */
+Datum
+pg_ash_history(PG_FUNCTION_ARGS)
+{
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	AshSample  *samples;
+	uint64		first;
+	uint64		next;
+	int			count;
+
+	if (!ash)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("pg_ash must be loaded via \"shared_preload_libraries\"")));
+
+	InitMaterializedSRF(fcinfo, 0);
+
+	/*
+	 * Copy the ring out under the lock so as to not hold up the sampler while
+	 * we build the result.
+	 */
+	LWLockAcquire(ash->lock, LW_SHARED);
+	next = ash->next;
+	first = (next > ash_max_samples) ? next - ash_max_samples : 0;
+	count = (int) (next - first);
+	/* max_samples allows a ring bigger than MaxAllocSize */
+	samples = palloc_extended(mul_size(sizeof(AshSample), Max(count, 1)),
+							  MCXT_ALLOC_HUGE);
+	for (int i = 0; i < count; i++)
+		samples[i] = ash->samples[(first + i) % ash_max_samples];
+	LWLockRelease(ash->lock);
+
+	for (int i = 0; i < count; i++)
+	{
+		AshSample  *s = &samples[i];
+		Datum		values[PG_ASH_HISTORY_COLS] = {0};
+		bool		nulls[PG_ASH_HISTORY_COLS] = {0};
+		const char *state;
+		const char *wait_event_type;
+		const char *wait_event;
+		int			j = 0;
+
+		values[j++] = TimestampTzGetDatum(s->sample_time);
+		values[j++] = Int32GetDatum(s->pid);
+		values[j++] = CStringGetTextDatum(GetBackendTypeDesc(s->backend_type));
+
+		if (OidIsValid(s->datid))
+			values[j++] = ObjectIdGetDatum(s->datid);
+		else
+			nulls[j++] = true;
+
+		if (OidIsValid(s->userid))
+			values[j++] = ObjectIdGetDatum(s->userid);
+		else
+			nulls[j++] = true;
+
+		state = ash_state_name(s->state);
+		if (state)
+			values[j++] = CStringGetTextDatum(state);
+		else
+			nulls[j++] = true;
+
+		/* A session that isn't waiting is running on CPU */
+		wait_event_type = pgstat_get_wait_event_type(s->wait_event_info);
+		wait_event = pgstat_get_wait_event(s->wait_event_info);
+
+		if (wait_event_type)
+			values[j++] = CStringGetTextDatum(wait_event_type);
+		else
+			nulls[j++] = true;
+
+		if (wait_event)
+			values[j++] = CStringGetTextDatum(wait_event);
+		else
+			nulls[j++] = true;
+
+		if (s->query_id != 0)
+			values[j++] = UInt64GetDatum(s->query_id);
+		else
+			nulls[j++] = true;
+
+		Assert(j == PG_ASH_HISTORY_COLS);
+
+		tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc,
+							 values, nulls);
+	}
+
+	pfree(samples);
+
+	return (Datum) 0;
+}
+
+/*
+ * Discard all samples collected so far.
+ */
+Datum
+pg_ash_reset(PG_FUNCTION_ARGS)
+{
+	if (!ash)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("pg_ash must be loaded via \"shared_preload_libraries\"")));
+
+	LWLockAcquire(ash->lock, LW_EXCLUSIVE);
+	ash->next = 0;
+	LWLockRelease(ash->lock);
+
+	PG_RETURN_VOID();
+}
@@ -0,0 +1,33 @@
+CREATE EXTENSION pg_ash;
+
+--
+-- A sleeping backend is active and waiting, so it should be sampled.
+--
+SELECT pg_ash_reset();
+-- Sleep until the sampler has seen us, in short steps so as not to depend
+-- on how quickly the sampler gets going.
+DO $$
+BEGIN
+  FOR i IN 1..600 LOOP
+    PERFORM pg_sleep(0.1);
+    EXIT WHEN EXISTS (SELECT 1 FROM pg_ash
+                      WHERE pid = pg_backend_pid() AND
+                            wait_event = 'PgSleep');
+  END LOOP;
+END
+$$;
+SELECT count(*) > 0 AS sampled
+  FROM pg_ash
+  WHERE pid = pg_backend_pid() AND state = 'active' AND
+        wait_event_type = 'Timeout' AND wait_event = 'PgSleep';
+
+-- The summary should attribute that time to the same wait event.
+SELECT wait_event_type, wait_event, samples > 0 AS ok
+  FROM pg_ash_wait_summary()
+  WHERE wait_event = 'PgSleep';
+
+-- Reset removes everything collected so far.
+SELECT pg_ash_reset();
+SELECT count(*) FROM pg_ash WHERE wait_event = 'PgSleep';
+
+DROP EXTENSION pg_ash;
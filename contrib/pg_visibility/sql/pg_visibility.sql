@@ -164,6 +164,29 @@ commit;
 select * from pg_visibility_map('copyfreeze');
 select * from pg_check_frozen('copyfreeze');
 
+-- eager freezing: a non-aggressive VACUUM freezes up to
+-- vacuum_eager_freeze_pages all-visible pages, and can advance relfrozenxid
+-- once there are no all-visible pages left to skip.
+create table eagerfreeze (a int, b char(1500)) with (autovacuum_enabled = false);
+insert into eagerfreeze select i, i from generate_series(1, 50) i;
+vacuum eagerfreeze;
+select relfrozenxid as frozenxid from pg_class
+  where oid = 'eagerfreeze'::regclass \gset
+set vacuum_eager_freeze_pages = 3;
+vacuum eagerfreeze;
+select * from pg_visibility_map('eagerfreeze');
+select relfrozenxid = :'frozenxid' from pg_class
+  where oid = 'eagerfreeze'::regclass;
+set vacuum_eager_freeze_pages = 100;
+set vacuum_freeze_min_age = 0;
+vacuum eagerfreeze;
+select * from pg_visibility_map('eagerfreeze');
+select * from pg_check_frozen('eagerfreeze');
+select relfrozenxid <> :'frozenxid' from pg_class
+  where oid = 'eagerfreeze'::regclass;
+reset vacuum_eager_freeze_pages;
+reset vacuum_freeze_min_age;
+
 -- cleanup
 drop table test_partitioned;
 drop view test_view;
@@ -174,3 +197,4 @@ drop foreign data wrapper dummy;
 drop materialized view matview_visibility_test;
 drop table regular_table;
 drop table copyfreeze;
+drop table eagerfreeze;
@@ -0,0 +1,48 @@
+# Copyright (c) 2024, PostgreSQL Global Development Group
+
+# Check that VACUUM reports how many all-visible pages it set all-frozen
+# eagerly, which is also what pg_stat_progress_vacuum.heap_blks_eager_frozen
+# shows while it runs.
+use strict;
+use warnings FATAL => 'all';
+use PostgreSQL::Test::Cluster;
+use PostgreSQL::Test::Utils;
+use Test::More;
+
+my $node = PostgreSQL::Test::Cluster->new('main');
+$node->init;
+$node->start;
+
+# Ten all-visible pages, none of them all-frozen
+$node->safe_psql(
+	'postgres', qq(
+CREATE EXTENSION pg_visibility;
+CREATE TABLE eagerfreeze (a int, b char(1500))
+  WITH (autovacuum_enabled = false);
+INSERT INTO eagerfreeze SELECT i, i FROM generate_series(1, 50) i;
+VACUUM eagerfreeze;
+));
+
+is( $node->safe_psql(
+		'postgres',
+		"SELECT count(*) FILTER (WHERE all_visible), count(*) FILTER (WHERE all_frozen) FROM pg_visibility_map('eagerfreeze')"
+	),
+	'10|0',
+	'pages are all-visible but not all-frozen');
+
+my ($ret, $stdout, $stderr) = $node->psql('postgres',
+	"SET vacuum_eager_freeze_pages = 3; VACUUM (VERBOSE) eagerfreeze;");
+is($ret, 0, 'VACUUM with an eager freezing budget succeeds');
+like(
+	$stderr,
+	qr/eager freezing: 3 of 10 all-visible pages set all-frozen/,
+	'VACUUM counts the pages it set all-frozen eagerly');
+
+is( $node->safe_psql(
+		'postgres',
+		"SELECT count(*) FILTER (WHERE all_frozen) FROM pg_visibility_map('eagerfreeze')"
+	),
+	'3',
+	'only the budgeted pages were set all-frozen');
+
+done_testing();
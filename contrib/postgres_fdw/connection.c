@@ -1605,6 +1605,14 @@ pgfdw_abort_cleanup(ConnCacheEntry *entry, bool toplevel)
 	if (in_error_recursion_trouble())
 		entry->changing_xact_state = true;
 
+	/*
+	 * An error while sending a pipeline of commands can leave the connection
+	 * in pipeline mode, with no way to tell which of them reached the remote
+	 * server.  Don't try to salvage it.
+	 */
+	if (PQpipelineStatus(entry->conn) != PQ_PIPELINE_OFF)
+		entry->changing_xact_state = true;
+
 	/*
 	 * If connection is already unsalvageable, don't touch it further.
 	 */
@@ -1678,6 +1686,14 @@ pgfdw_abort_cleanup_begin(ConnCacheEntry *entry, bool toplevel,
 	if (in_error_recursion_trouble())
 		entry->changing_xact_state = true;
 
+	/*
+	 * An error while sending a pipeline of commands can leave the connection
+	 * in pipeline mode, with no way to tell which of them reached the remote
+	 * server.  Don't try to salvage it.
+	 */
+	if (PQpipelineStatus(entry->conn) != PQ_PIPELINE_OFF)
+		entry->changing_xact_state = true;
+
 	/*
 	 * If connection is already unsalvageable, don't touch it further.
 	 */
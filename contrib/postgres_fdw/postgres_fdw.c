@@ -148,6 +148,10 @@ typedef struct PgFdwScanState
 	PgFdwConnState *conn_state; /* extra per-connection state */
 	unsigned int cursor_number; /* quasi-unique ID for my cursor */
 	bool		cursor_exists;	/* have we created the cursor? */
+	bool		cursor_close_pending;	/* must old cursor be closed before
+										 * creating it again? */
+	PGresult   *pipelined_fetch;	/* result of FETCH sent along with DECLARE,
+									 * not yet processed */
 	int			numParams;		/* number of parameters passed to query */
 	FmgrInfo   *param_flinfo;	/* output conversion functions for them */
 	List	   *param_exprs;	/* executable expressions for param values */
@@ -447,6 +451,9 @@ static bool ec_member_matches_foreign(PlannerInfo *root, RelOptInfo *rel,
 									  EquivalenceClass *ec, EquivalenceMember *em,
 									  void *arg);
 static void create_cursor(ForeignScanState *node);
+static void create_cursor_pipelined(ForeignScanState *node,
+									const char *declare_sql,
+									bool send_close, bool send_fetch);
 static void fetch_more_data(ForeignScanState *node);
 static void close_cursor(PGconn *conn, unsigned int cursor_number,
 						 PgFdwConnState *conn_state);
@@ -1672,24 +1679,31 @@ postgresReScanForeignScan(ForeignScanState *node)
 	 * to check the scrollability of it, so destroy and recreate it in any
 	 * case.  If we've only fetched zero or one batch, we needn't even rewind
 	 * the cursor, just rescan what we have.
+	 *
+	 * When the cursor is to be destroyed, we don't close it right away, but
+	 * let create_cursor() send the CLOSE in the same pipeline as the commands
+	 * that recreate it, saving a round trip per rescan.  That matters for
+	 * parameterized scans on the inner side of a nested loop.
 	 */
-	if (node->ss.ps.chgParam != NULL)
+	if (node->ss.ps.chgParam != NULL ||
+		(fsstate->fetch_ct_2 > 1 && PQserverVersion(fsstate->conn) >= 150000))
 	{
 		fsstate->cursor_exists = false;
-		snprintf(sql, sizeof(sql), "CLOSE c%u",
-				 fsstate->cursor_number);
+		fsstate->cursor_close_pending = true;
 	}
 	else if (fsstate->fetch_ct_2 > 1)
 	{
-		if (PQserverVersion(fsstate->conn) < 150000)
-			snprintf(sql, sizeof(sql), "MOVE BACKWARD ALL IN c%u",
-					 fsstate->cursor_number);
-		else
-		{
-			fsstate->cursor_exists = false;
-			snprintf(sql, sizeof(sql), "CLOSE c%u",
-					 fsstate->cursor_number);
-		}
+		snprintf(sql, sizeof(sql), "MOVE BACKWARD ALL IN c%u",
+				 fsstate->cursor_number);
+
+		/*
+		 * We don't use a PG_TRY block here, so be careful not to throw error
+		 * without releasing the PGresult.
+		 */
+		res = pgfdw_exec_query(fsstate->conn, sql, fsstate->conn_state);
+		if (PQresultStatus(res) != PGRES_COMMAND_OK)
+			pgfdw_report_error(ERROR, res, fsstate->conn, true, sql);
+		PQclear(res);
 	}
 	else
 	{
@@ -1698,16 +1712,9 @@ postgresReScanForeignScan(ForeignScanState *node)
 		return;
 	}
 
-	/*
-	 * We don't use a PG_TRY block here, so be careful not to throw error
-	 * without releasing the PGresult.
-	 */
-	res = pgfdw_exec_query(fsstate->conn, sql, fsstate->conn_state);
-	if (PQresultStatus(res) != PGRES_COMMAND_OK)
-		pgfdw_report_error(ERROR, res, fsstate->conn, true, sql);
-	PQclear(res);
-
 	/* Now force a fresh FETCH. */
+	PQclear(fsstate->pipelined_fetch);
+	fsstate->pipelined_fetch = NULL;
 	fsstate->tuples = NULL;
 	fsstate->num_tuples = 0;
 	fsstate->next_tuple = 0;
@@ -1728,8 +1735,11 @@ postgresEndForeignScan(ForeignScanState *node)
 	if (fsstate == NULL)
 		return;
 
+	PQclear(fsstate->pipelined_fetch);
+	fsstate->pipelined_fetch = NULL;
+
 	/* Close the cursor if open, to prevent accumulation of cursors */
-	if (fsstate->cursor_exists)
+	if (fsstate->cursor_exists || fsstate->cursor_close_pending)
 		close_cursor(fsstate->conn, fsstate->cursor_number,
 					 fsstate->conn_state);
 
@@ -3723,6 +3733,11 @@ ec_member_matches_foreign(PlannerInfo *root, RelOptInfo *rel,
 
 /*
  * Create cursor for node's query with current parameter values.
+ *
+ * In sync mode, the first FETCH is sent in the same pipeline as the DECLARE
+ * CURSOR, along with the CLOSE of the previous incarnation of the cursor if
+ * a rescan left one behind, so that the whole thing takes one round trip.
+ * The result of the FETCH is stashed for fetch_more_data() to process.
  */
 static void
 create_cursor(ForeignScanState *node)
@@ -3732,6 +3747,8 @@ create_cursor(ForeignScanState *node)
 	int			numParams = fsstate->numParams;
 	const char **values = fsstate->param_values;
 	PGconn	   *conn = fsstate->conn;
+	bool		send_close = fsstate->cursor_close_pending;
+	bool		send_fetch = !fsstate->async_capable;
 	StringInfoData buf;
 	PGresult   *res;
 
@@ -3763,30 +3780,39 @@ create_cursor(ForeignScanState *node)
 	appendStringInfo(&buf, "DECLARE c%u CURSOR FOR\n%s",
 					 fsstate->cursor_number, fsstate->query);
 
-	/*
-	 * Notice that we pass NULL for paramTypes, thus forcing the remote server
-	 * to infer types for all parameters.  Since we explicitly cast every
-	 * parameter (see deparse.c), the "inference" is trivial and will produce
-	 * the desired result.  This allows us to avoid assuming that the remote
-	 * server has the same OIDs we do for the parameters' types.
-	 */
-	if (!PQsendQueryParams(conn, buf.data, numParams,
-						   NULL, values, NULL, NULL, 0))
-		pgfdw_report_error(ERROR, NULL, conn, false, buf.data);
+	if (send_close || send_fetch)
+	{
+		create_cursor_pipelined(node, buf.data, send_close, send_fetch);
+	}
+	else
+	{
+		/*
+		 * Notice that we pass NULL for paramTypes, thus forcing the remote
+		 * server to infer types for all parameters.  Since we explicitly
+		 * cast every parameter (see deparse.c), the "inference" is trivial
+		 * and will produce the desired result.  This allows us to avoid
+		 * assuming that the remote server has the same OIDs we do for the
+		 * parameters' types.
+		 */
+		if (!PQsendQueryParams(conn, buf.data, numParams,
+							   NULL, values, NULL, NULL, 0))
+			pgfdw_report_error(ERROR, NULL, conn, false, buf.data);
 
-	/*
-	 * Get the result, and check for success.
-	 *
-	 * We don't use a PG_TRY block here, so be careful not to throw error
-	 * without releasing the PGresult.
-	 */
-	res = pgfdw_get_result(conn);
-	if (PQresultStatus(res) != PGRES_COMMAND_OK)
-		pgfdw_report_error(ERROR, res, conn, true, fsstate->query);
-	PQclear(res);
+		/*
+		 * Get the result, and check for success.
+		 *
+		 * We don't use a PG_TRY block here, so be careful not to throw error
+		 * without releasing the PGresult.
+		 */
+		res = pgfdw_get_result(conn);
+		if (PQresultStatus(res) != PGRES_COMMAND_OK)
+			pgfdw_report_error(ERROR, res, conn, true, fsstate->query);
+		PQclear(res);
+	}
 
 	/* Mark the cursor as created, and show no tuples have been retrieved */
 	fsstate->cursor_exists = true;
+	fsstate->cursor_close_pending = false;
 	fsstate->tuples = NULL;
 	fsstate->num_tuples = 0;
 	fsstate->next_tuple = 0;
@@ -3797,6 +3823,97 @@ create_cursor(ForeignScanState *node)
 	pfree(buf.data);
 }
 
+/*
+ * Send the commands to (re)create the node's cursor in a pipeline, and
+ * collect their results.
+ *
+ * 'declare_sql' is the DECLARE CURSOR command.  If 'send_close', it's preceded
+ * by a CLOSE of the cursor; if 'send_fetch', it's followed by a FETCH whose
+ * result is left in fsstate->pipelined_fetch.
+ */
+static void
+create_cursor_pipelined(ForeignScanState *node, const char *declare_sql,
+						bool send_close, bool send_fetch)
+{
+	PgFdwScanState *fsstate = (PgFdwScanState *) node->fdw_state;
+	PGconn	   *conn = fsstate->conn;
+	char		close_sql[64];
+	char		fetch_sql[64];
+	PGresult   *volatile close_res = NULL;
+	PGresult   *volatile declare_res = NULL;
+	PGresult   *volatile fetch_res = NULL;
+	PGresult   *volatile sync_res = NULL;
+
+	snprintf(close_sql, sizeof(close_sql), "CLOSE c%u",
+			 fsstate->cursor_number);
+	snprintf(fetch_sql, sizeof(fetch_sql), "FETCH %d FROM c%u",
+			 fsstate->fetch_size, fsstate->cursor_number);
+
+	/*
+	 * If we fail to send anything, the connection is left in pipeline mode;
+	 * pgfdw_abort_cleanup() will then give up on it, which is fine since
+	 * failures to send mean the connection is broken anyway.
+	 */
+	if (!PQenterPipelineMode(conn))
+		pgfdw_report_error(ERROR, NULL, conn, false, declare_sql);
+	if (send_close &&
+		!PQsendQueryParams(conn, close_sql, 0, NULL, NULL, NULL, NULL, 0))
+		pgfdw_report_error(ERROR, NULL, conn, false, close_sql);
+	/* As in create_cursor(), we pass NULL for paramTypes. */
+	if (!PQsendQueryParams(conn, declare_sql, fsstate->numParams,
+						   NULL, fsstate->param_values, NULL, NULL, 0))
+		pgfdw_report_error(ERROR, NULL, conn, false, declare_sql);
+	if (send_fetch &&
+		!PQsendQueryParams(conn, fetch_sql, 0, NULL, NULL, NULL, NULL, 0))
+		pgfdw_report_error(ERROR, NULL, conn, false, fetch_sql);
+	if (!PQpipelineSync(conn))
+		pgfdw_report_error(ERROR, NULL, conn, false, declare_sql);
+
+	/* PGresults must be released before leaving this function. */
+	PG_TRY();
+	{
+		/*
+		 * Collect all the results up to the sync point before checking any
+		 * of them, so that the connection is out of pipeline mode again when
+		 * we report an error.  Commands after a failed one are not executed,
+		 * and their results are of type PGRES_PIPELINE_ABORTED.
+		 */
+		if (send_close)
+			close_res = pgfdw_get_result(conn);
+		declare_res = pgfdw_get_result(conn);
+		if (send_fetch)
+			fetch_res = pgfdw_get_result(conn);
+		sync_res = pgfdw_get_result(conn);
+		if (PQresultStatus(sync_res) != PGRES_PIPELINE_SYNC ||
+			!PQexitPipelineMode(conn))
+			pgfdw_report_error(ERROR, sync_res, conn, false, declare_sql);
+
+		if (send_close && PQresultStatus(close_res) != PGRES_COMMAND_OK)
+			pgfdw_report_error(ERROR, close_res, conn, false, close_sql);
+		if (PQresultStatus(declare_res) != PGRES_COMMAND_OK)
+			pgfdw_report_error(ERROR, declare_res, conn, false, fsstate->query);
+		/* On error, report the original query, not the FETCH. */
+		if (send_fetch && PQresultStatus(fetch_res) != PGRES_TUPLES_OK)
+			pgfdw_report_error(ERROR, fetch_res, conn, false, fsstate->query);
+	}
+	PG_CATCH();
+	{
+		PQclear(close_res);
+		PQclear(declare_res);
+		PQclear(fetch_res);
+		PQclear(sync_res);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	PQclear(close_res);
+	PQclear(declare_res);
+	PQclear(sync_res);
+
+	Assert(fsstate->pipelined_fetch == NULL);
+	fsstate->pipelined_fetch = fetch_res;
+}
+
 /*
  * Fetch some more rows from the node's cursor.
  */
@@ -3838,6 +3955,15 @@ fetch_more_data(ForeignScanState *node)
 			/* Reset per-connection state */
 			fsstate->conn_state->pendingAreq = NULL;
 		}
+		else if (fsstate->pipelined_fetch)
+		{
+			/*
+			 * create_cursor() already sent the FETCH, and checked that it
+			 * succeeded.  Just take over its result.
+			 */
+			res = fsstate->pipelined_fetch;
+			fsstate->pipelined_fetch = NULL;
+		}
 		else
 		{
 			char		sql[64];
@@ -323,6 +323,10 @@ heap_page_prune_opt(Relation relation, Buffer buffer)
  *   FREEZE indicates that we will also freeze tuples, and will return
  *   'all_visible', 'all_frozen' flags to the caller.
  *
+ *   FREEZE_EAGER indicates that we should freeze the page whenever doing so
+ *   allows it to be set all-frozen, even when no FPI would be emitted for it.
+ *   Only meaningful together with FREEZE.
+ *
  * cutoffs contains the freeze cutoffs, established by VACUUM at the beginning
  * of vacuuming the relation.  Required if HEAP_PRUNE_FREEZE option is set.
  * cutoffs->OldestXmin is also used to determine if dead tuples are
@@ -699,10 +703,13 @@ heap_page_prune_and_freeze(Relation relation, Buffer buffer,
 			if (prstate.all_visible && prstate.all_frozen && prstate.nfrozen > 0)
 			{
 				/*
-				 * Freezing would make the page all-frozen.  Have already
-				 * emitted an FPI or will do so anyway?
+				 * Freezing would make the page all-frozen.  Caller asked us
+				 * to freeze such pages eagerly, or have already emitted an
+				 * FPI or will do so anyway?
 				 */
-				if (RelationNeedsWAL(relation))
+				if ((options & HEAP_PAGE_PRUNE_FREEZE_EAGER) != 0)
+					do_freeze = true;
+				else if (RelationNeedsWAL(relation))
 				{
 					if (hint_bit_fpi)
 						do_freeze = true;
@@ -162,6 +162,15 @@ typedef struct LVRelState
 	MultiXactId NewRelminMxid;
 	bool		skippedallvis;
 
+	/*
+	 * Eager freezing state.  freeze_debt is the number of all-visible but not
+	 * all-frozen pages according to the VM at the start of VACUUM, and
+	 * eager_freeze_budget is how many more of these pages a non-aggressive
+	 * VACUUM may still scan (instead of skipping) in order to freeze them.
+	 */
+	BlockNumber freeze_debt;
+	BlockNumber eager_freeze_budget;
+
 	/* Error reporting state */
 	char	   *dbname;
 	char	   *relnamespace;
@@ -189,6 +198,7 @@ typedef struct LVRelState
 	BlockNumber scanned_pages;	/* # pages examined (not skipped via VM) */
 	BlockNumber removed_pages;	/* # pages removed by relation truncation */
 	BlockNumber frozen_pages;	/* # pages with newly frozen tuples */
+	BlockNumber eager_frozen_pages; /* # pages set all-frozen eagerly */
 	BlockNumber lpdead_item_pages;	/* # pages with LP_DEAD items */
 	BlockNumber missed_dead_pages;	/* # pages with missed dead tuples */
 	BlockNumber nonempty_pages; /* actually, last nonempty page + 1 */
@@ -213,6 +223,7 @@ typedef struct LVRelState
 	BlockNumber current_block;	/* last block returned */
 	BlockNumber next_unskippable_block; /* next unskippable block */
 	bool		next_unskippable_allvis;	/* its visibility status */
+	bool		next_unskippable_eager; /* scanned only to freeze it eagerly? */
 	Buffer		next_unskippable_vmbuffer;	/* buffer containing its VM bit */
 } LVRelState;
 
@@ -228,7 +239,8 @@ typedef struct LVSavedErrInfo
 /* non-export function prototypes */
 static void lazy_scan_heap(LVRelState *vacrel);
 static bool heap_vac_scan_next_block(LVRelState *vacrel, BlockNumber *blkno,
-									 bool *all_visible_according_to_vm);
+									 bool *all_visible_according_to_vm,
+									 bool *eager_freeze);
 static void find_next_unskippable_block(LVRelState *vacrel, bool *skipsallvis);
 static bool lazy_scan_new_or_empty(LVRelState *vacrel, Buffer buf,
 								   BlockNumber blkno, Page page,
@@ -236,7 +248,7 @@ static bool lazy_scan_new_or_empty(LVRelState *vacrel, Buffer buf,
 static void lazy_scan_prune(LVRelState *vacrel, Buffer buf,
 							BlockNumber blkno, Page page,
 							Buffer vmbuffer, bool all_visible_according_to_vm,
-							bool *has_lpdead_items);
+							bool eager_freeze, bool *has_lpdead_items);
 static bool lazy_scan_noprune(LVRelState *vacrel, Buffer buf,
 							  BlockNumber blkno, Page page,
 							  bool *has_lpdead_items);
@@ -408,6 +420,7 @@ heap_vacuum_rel(Relation rel, VacuumParams *params,
 	vacrel->scanned_pages = 0;
 	vacrel->removed_pages = 0;
 	vacrel->frozen_pages = 0;
+	vacrel->eager_frozen_pages = 0;
 	vacrel->lpdead_item_pages = 0;
 	vacrel->missed_dead_pages = 0;
 	vacrel->nonempty_pages = 0;
@@ -464,6 +477,31 @@ heap_vacuum_rel(Relation rel, VacuumParams *params,
 
 	vacrel->skipwithvm = skipwithvm;
 
+	/*
+	 * Work out this VACUUM's eager freezing budget.  A non-aggressive VACUUM
+	 * normally skips all-visible pages, leaving any unfrozen XIDs on them to
+	 * the next aggressive VACUUM.  On append-mostly tables that can add up to
+	 * a huge anti-wraparound VACUUM that has to scan and freeze most of the
+	 * table at once.  Spread that work out by scanning up to
+	 * vacuum_eager_freeze_pages all-visible, not-all-frozen pages in each
+	 * non-aggressive VACUUM, freezing them whenever that allows them to be
+	 * set all-frozen.  Once the freeze debt has been paid off entirely, such
+	 * a VACUUM can also advance relfrozenxid.
+	 */
+	vacrel->freeze_debt = 0;
+	vacrel->eager_freeze_budget = 0;
+	if (!vacrel->aggressive && skipwithvm && vacuum_eager_freeze_pages > 0)
+	{
+		BlockNumber allvisible,
+					allfrozen;
+
+		visibilitymap_count(rel, &allvisible, &allfrozen);
+		if (allvisible > allfrozen)
+			vacrel->freeze_debt = allvisible - allfrozen;
+		vacrel->eager_freeze_budget = Min(vacrel->freeze_debt,
+										  (BlockNumber) vacuum_eager_freeze_pages);
+	}
+
 	if (verbose)
 	{
 		if (vacrel->aggressive)
@@ -700,6 +738,10 @@ heap_vacuum_rel(Relation rel, VacuumParams *params,
 							 orig_rel_pages == 0 ? 100.0 :
 							 100.0 * vacrel->frozen_pages / orig_rel_pages,
 							 (long long) vacrel->tuples_frozen);
+			if (vacrel->freeze_debt > 0)
+				appendStringInfo(&buf, _("eager freezing: %u of %u all-visible pages set all-frozen\n"),
+								 vacrel->eager_frozen_pages,
+								 vacrel->freeze_debt);
 			if (vacrel->do_index_vacuuming)
 			{
 				if (vacrel->nindexes == 0 || vacrel->num_index_scans == 0)
@@ -826,7 +868,8 @@ lazy_scan_heap(LVRelState *vacrel)
 	BlockNumber rel_pages = vacrel->rel_pages,
 				blkno,
 				next_fsm_block_to_vacuum = 0;
-	bool		all_visible_according_to_vm;
+	bool		all_visible_according_to_vm,
+				eager_freeze;
 
 	TidStore   *dead_items = vacrel->dead_items;
 	VacDeadItemsInfo *dead_items_info = vacrel->dead_items_info;
@@ -834,23 +877,27 @@ lazy_scan_heap(LVRelState *vacrel)
 	const int	initprog_index[] = {
 		PROGRESS_VACUUM_PHASE,
 		PROGRESS_VACUUM_TOTAL_HEAP_BLKS,
-		PROGRESS_VACUUM_MAX_DEAD_TUPLE_BYTES
+		PROGRESS_VACUUM_MAX_DEAD_TUPLE_BYTES,
+		PROGRESS_VACUUM_HEAP_BLKS_FREEZE_DEBT
 	};
-	int64		initprog_val[3];
+	int64		initprog_val[4];
 
 	/* Report that we're scanning the heap, advertising total # of blocks */
 	initprog_val[0] = PROGRESS_VACUUM_PHASE_SCAN_HEAP;
 	initprog_val[1] = rel_pages;
 	initprog_val[2] = dead_items_info->max_bytes;
-	pgstat_progress_update_multi_param(3, initprog_index, initprog_val);
+	initprog_val[3] = vacrel->freeze_debt;
+	pgstat_progress_update_multi_param(4, initprog_index, initprog_val);
 
 	/* Initialize for the first heap_vac_scan_next_block() call */
 	vacrel->current_block = InvalidBlockNumber;
 	vacrel->next_unskippable_block = InvalidBlockNumber;
 	vacrel->next_unskippable_allvis = false;
+	vacrel->next_unskippable_eager = false;
 	vacrel->next_unskippable_vmbuffer = InvalidBuffer;
 
-	while (heap_vac_scan_next_block(vacrel, &blkno, &all_visible_according_to_vm))
+	while (heap_vac_scan_next_block(vacrel, &blkno, &all_visible_according_to_vm,
+									&eager_freeze))
 	{
 		Buffer		buf;
 		Page		page;
@@ -982,7 +1029,7 @@ lazy_scan_heap(LVRelState *vacrel)
 		if (got_cleanup_lock)
 			lazy_scan_prune(vacrel, buf, blkno, page,
 							vmbuffer, all_visible_according_to_vm,
-							&has_lpdead_items);
+							eager_freeze, &has_lpdead_items);
 
 		/*
 		 * Now drop the buffer lock and, potentially, update the FSM.
@@ -1081,8 +1128,10 @@ lazy_scan_heap(LVRelState *vacrel)
  * sets blkno to the next block to process.
  *
  * The block number and visibility status of the next block to process are set
- * in *blkno and *all_visible_according_to_vm.  The return value is false if
- * there are no further blocks to process.
+ * in *blkno and *all_visible_according_to_vm.  *eager_freeze is set when the
+ * block is all-visible and would have been skipped, but is being scanned to
+ * spend the eager freezing budget.  The return value is false if there are no
+ * further blocks to process.
  *
  * vacrel is an in/out parameter here.  Vacuum options and information about
  * the relation are read.  vacrel->skippedallvis is set if we skip a block
@@ -1092,7 +1141,8 @@ lazy_scan_heap(LVRelState *vacrel)
  */
 static bool
 heap_vac_scan_next_block(LVRelState *vacrel, BlockNumber *blkno,
-						 bool *all_visible_according_to_vm)
+						 bool *all_visible_according_to_vm,
+						 bool *eager_freeze)
 {
 	BlockNumber next_block;
 
@@ -1159,6 +1209,7 @@ heap_vac_scan_next_block(LVRelState *vacrel, BlockNumber *blkno,
 		 */
 		*blkno = vacrel->current_block = next_block;
 		*all_visible_according_to_vm = true;
+		*eager_freeze = false;
 		return true;
 	}
 	else
@@ -1171,6 +1222,7 @@ heap_vac_scan_next_block(LVRelState *vacrel, BlockNumber *blkno,
 
 		*blkno = vacrel->current_block = next_block;
 		*all_visible_according_to_vm = vacrel->next_unskippable_allvis;
+		*eager_freeze = vacrel->next_unskippable_eager;
 		return true;
 	}
 }
@@ -1195,6 +1247,7 @@ find_next_unskippable_block(LVRelState *vacrel, bool *skipsallvis)
 	BlockNumber next_unskippable_block = vacrel->next_unskippable_block + 1;
 	Buffer		next_unskippable_vmbuffer = vacrel->next_unskippable_vmbuffer;
 	bool		next_unskippable_allvis;
+	bool		next_unskippable_eager = false;
 
 	*skipsallvis = false;
 
@@ -1243,6 +1296,18 @@ find_next_unskippable_block(LVRelState *vacrel, bool *skipsallvis)
 			if (vacrel->aggressive)
 				break;
 
+			/*
+			 * Non-aggressive VACUUM scans all-visible blocks anyway while it
+			 * still has eager freezing budget left, so that it gets a chance
+			 * to freeze them.
+			 */
+			if (vacrel->eager_freeze_budget > 0)
+			{
+				vacrel->eager_freeze_budget--;
+				next_unskippable_eager = true;
+				break;
+			}
+
 			/*
 			 * All-visible block is safe to skip in non-aggressive case.  But
 			 * remember that the final range contains such a block for later.
@@ -1256,6 +1321,7 @@ find_next_unskippable_block(LVRelState *vacrel, bool *skipsallvis)
 	/* write the local variables back to vacrel */
 	vacrel->next_unskippable_block = next_unskippable_block;
 	vacrel->next_unskippable_allvis = next_unskippable_allvis;
+	vacrel->next_unskippable_eager = next_unskippable_eager;
 	vacrel->next_unskippable_vmbuffer = next_unskippable_vmbuffer;
 }
 
@@ -1407,6 +1473,9 @@ cmpOffsetNumbers(const void *a, const void *b)
  * visibility status of the heap block looked up earlier by the caller. We
  * won't rely entirely on this status, as it may be out of date.
  *
+ * eager_freeze indicates that the block was scanned only so that it could be
+ * frozen eagerly; we then freeze it whenever that makes it all-frozen.
+ *
  * *has_lpdead_items is set to true or false depending on whether, upon return
  * from this function, any LP_DEAD items are still present on the page.
  */
@@ -1417,6 +1486,7 @@ lazy_scan_prune(LVRelState *vacrel,
 				Page page,
 				Buffer vmbuffer,
 				bool all_visible_according_to_vm,
+				bool eager_freeze,
 				bool *has_lpdead_items)
 {
 	Relation	rel = vacrel->rel;
@@ -1443,6 +1513,8 @@ lazy_scan_prune(LVRelState *vacrel,
 	prune_options = HEAP_PAGE_PRUNE_FREEZE;
 	if (vacrel->nindexes == 0)
 		prune_options |= HEAP_PAGE_PRUNE_MARK_UNUSED_NOW;
+	if (eager_freeze)
+		prune_options |= HEAP_PAGE_PRUNE_FREEZE_EAGER;
 
 	heap_page_prune_and_freeze(rel, buf, vacrel->vistest, prune_options,
 							   &vacrel->cutoffs, &presult, PRUNE_VACUUM_SCAN,
@@ -1629,6 +1701,17 @@ lazy_scan_prune(LVRelState *vacrel,
 						  vmbuffer, InvalidTransactionId,
 						  VISIBILITYMAP_ALL_VISIBLE |
 						  VISIBILITYMAP_ALL_FROZEN);
+
+		/*
+		 * Count the page if it was scanned only to freeze it eagerly, whether
+		 * or not any of its tuples had to be frozen just now.
+		 */
+		if (eager_freeze)
+		{
+			vacrel->eager_frozen_pages++;
+			pgstat_progress_update_param(PROGRESS_VACUUM_HEAP_BLKS_EAGER_FROZEN,
+										 vacrel->eager_frozen_pages);
+		}
 	}
 }
 
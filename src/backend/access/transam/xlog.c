@@ -2454,7 +2454,9 @@ XLogWrite(XLogwrtRqst WriteRqst, TimeLineID tli, bool flexible)
 					instr_time	end;
 
 					INSTR_TIME_SET_CURRENT(end);
-					INSTR_TIME_ACCUM_DIFF(PendingWalStats.wal_write_time, end, start);
+					INSTR_TIME_SUBTRACT(end, start);
+					INSTR_TIME_ADD(PendingWalStats.wal_write_time, end);
+					PendingWalStats.wal_write_hist[pgstat_latency_hist_bucket(end)]++;
 				}
 
 				PendingWalStats.wal_write++;
@@ -8754,7 +8756,9 @@ issue_xlog_fsync(int fd, XLogSegNo segno, TimeLineID tli)
 		instr_time	end;
 
 		INSTR_TIME_SET_CURRENT(end);
-		INSTR_TIME_ACCUM_DIFF(PendingWalStats.wal_sync_time, end, start);
+		INSTR_TIME_SUBTRACT(end, start);
+		INSTR_TIME_ADD(PendingWalStats.wal_sync_time, end);
+		PendingWalStats.wal_sync_hist[pgstat_latency_hist_bucket(end)]++;
 	}
 
 	PendingWalStats.wal_sync++;
@@ -668,10 +668,12 @@ XLogPrefetcherNextBlock(uintptr_t pgsr_private, XLogRecPtr *lsn)
 			}
 
 			/*
-			 * If there is a full page image attached, we won't be reading the
-			 * page, so don't bother trying to prefetch.
+			 * If there is a full page image attached that will be restored,
+			 * we won't be reading the page, so don't bother trying to
+			 * prefetch.  Images logged only for wal_consistency_checking are
+			 * not restored, and the page is read as usual.
 			 */
-			if (block->has_image)
+			if (block->apply_image)
 			{
 				XLogPrefetchIncrement(&SharedStats->skip_fpw);
 				return LRQ_NEXT_NO_IO;
@@ -266,6 +266,14 @@ be_tls_init(bool isServerStart)
 	/* disallow SSL compression */
 	SSL_CTX_set_options(context, SSL_OP_NO_COMPRESSION);
 
+	/*
+	 * Let OpenSSL read whatever data is available from the socket, rather
+	 * than reading the header and the body of each record with separate
+	 * system calls.  That matters for bulk input such as COPY FROM.  We
+	 * don't use SSL_pending(), which doesn't account for data read ahead.
+	 */
+	SSL_CTX_set_read_ahead(context, 1);
+
 	/*
 	 * Disallow SSL renegotiation.  This concerns only TLSv1.2 and older
 	 * protocol versions, as TLSv1.3 has no support for renegotiation.
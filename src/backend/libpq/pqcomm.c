@@ -112,11 +112,15 @@ static List *sock_paths = NIL;
 /*
  * Buffers for low-level I/O.
  *
- * The receive buffer is fixed size. Send buffer is usually 8k, but can be
+ * The receive buffer is fixed size, but messages larger than it are read
+ * directly into the caller's buffer.  Send buffer is usually 8k, but can be
  * enlarged by pq_putmessage_noblock() if the message doesn't fit otherwise.
+ * It also grows, up to PQ_SEND_BUFFER_MAX_SIZE, while a large amount of
+ * output is being sent, and shrinks back when the output has been flushed.
  */
 
 #define PQ_SEND_BUFFER_SIZE 8192
+#define PQ_SEND_BUFFER_MAX_SIZE (128 * 1024)
 #define PQ_RECV_BUFFER_SIZE 8192
 
 static char *PqSendBuffer;
@@ -148,6 +152,7 @@ static inline int internal_putbytes(const char *s, size_t len);
 static inline int internal_flush(void);
 static pg_noinline int internal_flush_buffer(const char *buf, size_t *start,
 											 size_t *end);
+static int	internal_recv(char *buf, size_t len);
 
 static int	Lock_AF_UNIX(const char *unixSocketDir, const char *unixSocketPath);
 static int	Setup_AF_UNIX(const char *sock_path);
@@ -897,6 +902,8 @@ socket_set_nonblocking(bool nonblocking)
 static int
 pq_recvbuf(void)
 {
+	int			r;
+
 	if (PqRecvPointer > 0)
 	{
 		if (PqRecvLength > PqRecvPointer)
@@ -911,18 +918,37 @@ pq_recvbuf(void)
 			PqRecvLength = PqRecvPointer = 0;
 	}
 
+	/* Can fill buffer from PqRecvLength and upwards */
+	r = internal_recv(PqRecvBuffer + PqRecvLength,
+					  PQ_RECV_BUFFER_SIZE - PqRecvLength);
+	if (r == EOF)
+		return EOF;
+
+	/* r contains number of bytes read, so just incr length */
+	PqRecvLength += r;
+	return 0;
+}
+
+/* --------------------------------
+ *		internal_recv - receive some data into the given buffer
+ *
+ *		Blocks until at least one byte is available.  Returns the number of
+ *		bytes received, or EOF if trouble.
+ * --------------------------------
+ */
+static int
+internal_recv(char *buf, size_t len)
+{
 	/* Ensure that we're in blocking mode */
 	socket_set_nonblocking(false);
 
-	/* Can fill buffer from PqRecvLength and upwards */
 	for (;;)
 	{
 		int			r;
 
 		errno = 0;
 
-		r = secure_read(MyProcPort, PqRecvBuffer + PqRecvLength,
-						PQ_RECV_BUFFER_SIZE - PqRecvLength);
+		r = secure_read(MyProcPort, buf, len);
 
 		if (r < 0)
 		{
@@ -950,9 +976,7 @@ pq_recvbuf(void)
 			 */
 			return EOF;
 		}
-		/* r contains number of bytes read, so just incr length */
-		PqRecvLength += r;
-		return 0;
+		return r;
 	}
 }
 
@@ -1068,6 +1092,22 @@ pq_getbytes(char *s, size_t len)
 
 	while (len > 0)
 	{
+		/*
+		 * If the buffer is empty and we need at least a bufferful of data,
+		 * receive it directly into the caller's space.
+		 */
+		if (PqRecvPointer >= PqRecvLength && len >= PQ_RECV_BUFFER_SIZE)
+		{
+			int			r;
+
+			r = internal_recv(s, len);
+			if (r == EOF)
+				return EOF;
+			s += r;
+			len -= r;
+			continue;
+		}
+
 		while (PqRecvPointer >= PqRecvLength)
 		{
 			if (pq_recvbuf())	/* If nothing in buffer, then recv some */
@@ -1284,6 +1324,26 @@ internal_putbytes(const char *s, size_t len)
 			socket_set_nonblocking(false);
 			if (internal_flush())
 				return EOF;
+
+			/*
+			 * Output that fills the buffer is likely to keep coming, as with
+			 * a large query result, so enlarge the buffer now that it's empty
+			 * to save on system calls.  If we run out of memory, just carry
+			 * on with the buffer we have.
+			 */
+			if (PqSendBufferSize < PQ_SEND_BUFFER_MAX_SIZE)
+			{
+				char	   *newbuf;
+
+				newbuf = repalloc_extended(PqSendBuffer,
+										   PqSendBufferSize * 2,
+										   MCXT_ALLOC_NO_OOM);
+				if (newbuf != NULL)
+				{
+					PqSendBuffer = newbuf;
+					PqSendBufferSize *= 2;
+				}
+			}
 		}
 
 		/*
@@ -1332,6 +1392,25 @@ socket_flush(void)
 	PqCommBusy = true;
 	socket_set_nonblocking(false);
 	res = internal_flush();
+
+	/*
+	 * Give back the memory of a send buffer enlarged for a large amount of
+	 * output, now that it has been sent.
+	 */
+	if (res == 0 && PqSendBufferSize > PQ_SEND_BUFFER_SIZE &&
+		PqSendStart == PqSendPointer)
+	{
+		char	   *newbuf;
+
+		newbuf = repalloc_extended(PqSendBuffer, PQ_SEND_BUFFER_SIZE,
+								   MCXT_ALLOC_NO_OOM);
+		if (newbuf != NULL)
+		{
+			PqSendBuffer = newbuf;
+			PqSendBufferSize = PQ_SEND_BUFFER_SIZE;
+		}
+	}
+
 	PqCommBusy = false;
 	return res;
 }
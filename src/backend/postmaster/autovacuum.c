@@ -193,6 +193,17 @@ typedef struct av_relation
 								 * reloptions, or NULL if none */
 } av_relation;
 
+/*
+ * struct to keep track of tables to vacuum and/or analyze, in the order in
+ * which they should be processed
+ */
+typedef struct av_candidate
+{
+	Oid			ac_relid;
+	bool		ac_wraparound;	/* at risk of XID/MXID wraparound? */
+	double		ac_score;		/* urgency, see relation_needs_vacanalyze */
+} av_candidate;
+
 /* struct to keep track of tables to vacuum and/or analyze, after rechecking */
 typedef struct autovac_table
 {
@@ -325,6 +336,7 @@ static int	db_comparator(const void *a, const void *b);
 static void autovac_recalculate_workers_for_balance(void);
 
 static void do_autovacuum(void);
+static int	av_candidate_comparator(const ListCell *a, const ListCell *b);
 static void FreeWorkerInfo(int code, Datum arg);
 
 static autovac_table *table_recheck_autovac(Oid relid, HTAB *table_toast_map,
@@ -338,7 +350,8 @@ static void relation_needs_vacanalyze(Oid relid, AutoVacOpts *relopts,
 									  Form_pg_class classForm,
 									  PgStat_StatTabEntry *tabentry,
 									  int effective_multixact_freeze_max_age,
-									  bool *dovacuum, bool *doanalyze, bool *wraparound);
+									  bool *dovacuum, bool *doanalyze, bool *wraparound,
+									  double *score);
 
 static void autovacuum_do_vac_analyze(autovac_table *tab,
 									  BufferAccessStrategy bstrategy);
@@ -1878,6 +1891,7 @@ do_autovacuum(void)
 	HeapTuple	tuple;
 	TableScanDesc relScan;
 	Form_pg_database dbForm;
+	List	   *candidates = NIL;
 	List	   *table_oids = NIL;
 	List	   *orphan_oids = NIL;
 	HASHCTL		ctl;
@@ -1990,6 +2004,7 @@ do_autovacuum(void)
 		bool		dovacuum;
 		bool		doanalyze;
 		bool		wraparound;
+		double		score;
 
 		if (classForm->relkind != RELKIND_RELATION &&
 			classForm->relkind != RELKIND_MATVIEW)
@@ -2030,11 +2045,18 @@ do_autovacuum(void)
 		/* Check if it needs vacuum or analyze */
 		relation_needs_vacanalyze(relid, relopts, classForm, tabentry,
 								  effective_multixact_freeze_max_age,
-								  &dovacuum, &doanalyze, &wraparound);
+								  &dovacuum, &doanalyze, &wraparound, &score);
 
-		/* Relations that need work are added to table_oids */
+		/* Relations that need work are added to the candidates */
 		if (dovacuum || doanalyze)
-			table_oids = lappend_oid(table_oids, relid);
+		{
+			av_candidate *cand = palloc(sizeof(av_candidate));
+
+			cand->ac_relid = relid;
+			cand->ac_wraparound = wraparound;
+			cand->ac_score = score;
+			candidates = lappend(candidates, cand);
+		}
 
 		/*
 		 * Remember TOAST associations for the second pass.  Note: we must do
@@ -2083,6 +2105,7 @@ do_autovacuum(void)
 		bool		dovacuum;
 		bool		doanalyze;
 		bool		wraparound;
+		double		score;
 
 		/*
 		 * We cannot safely process other backends' temp tables, so skip 'em.
@@ -2113,16 +2136,38 @@ do_autovacuum(void)
 
 		relation_needs_vacanalyze(relid, relopts, classForm, tabentry,
 								  effective_multixact_freeze_max_age,
-								  &dovacuum, &doanalyze, &wraparound);
+								  &dovacuum, &doanalyze, &wraparound, &score);
 
 		/* ignore analyze for toast tables */
 		if (dovacuum)
-			table_oids = lappend_oid(table_oids, relid);
+		{
+			av_candidate *cand = palloc(sizeof(av_candidate));
+
+			cand->ac_relid = relid;
+			cand->ac_wraparound = wraparound;
+			cand->ac_score = score;
+			candidates = lappend(candidates, cand);
+		}
 	}
 
 	table_endscan(relScan);
 	table_close(classRel, AccessShareLock);
 
+	/*
+	 * Process the most urgent tables first, rather than in pg_class order.
+	 * Otherwise, in databases with many tables, a table that is about to
+	 * wrap around or that is bloating quickly could be stuck behind any
+	 * number of tables that barely crossed their thresholds.
+	 */
+	list_sort(candidates, av_candidate_comparator);
+	foreach(cell, candidates)
+	{
+		av_candidate *cand = (av_candidate *) lfirst(cell);
+
+		table_oids = lappend_oid(table_oids, cand->ac_relid);
+	}
+	list_free_deep(candidates);
+
 	/*
 	 * Recheck orphan temporary tables, and if they still seem orphaned, drop
 	 * them.  We'll eat a transaction per dropped table, which might seem
@@ -2561,6 +2606,24 @@ deleted:
 	CommitTransactionCommand();
 }
 
+/*
+ * list_sort comparator for av_candidate entries: tables at risk of wraparound
+ * go first, then everything else by decreasing score.  Ties are broken by OID
+ * so that the order is deterministic.
+ */
+static int
+av_candidate_comparator(const ListCell *a, const ListCell *b)
+{
+	av_candidate *ca = (av_candidate *) lfirst(a);
+	av_candidate *cb = (av_candidate *) lfirst(b);
+
+	if (ca->ac_wraparound != cb->ac_wraparound)
+		return ca->ac_wraparound ? -1 : 1;
+	if (ca->ac_score != cb->ac_score)
+		return ca->ac_score > cb->ac_score ? -1 : 1;
+	return pg_cmp_u32(ca->ac_relid, cb->ac_relid);
+}
+
 /*
  * Execute a previously registered work item.
  */
@@ -2858,6 +2921,7 @@ recheck_relation_needs_vacanalyze(Oid relid,
 								  bool *wraparound)
 {
 	PgStat_StatTabEntry *tabentry;
+	double		score;
 
 	/* fetch the pgstat table entry */
 	tabentry = pgstat_fetch_stat_tabentry_ext(classForm->relisshared,
@@ -2865,7 +2929,7 @@ recheck_relation_needs_vacanalyze(Oid relid,
 
 	relation_needs_vacanalyze(relid, avopts, classForm, tabentry,
 							  effective_multixact_freeze_max_age,
-							  dovacuum, doanalyze, wraparound);
+							  dovacuum, doanalyze, wraparound, &score);
 
 	/* ignore ANALYZE for toast tables */
 	if (classForm->relkind == RELKIND_TOASTVALUE)
@@ -2877,7 +2941,8 @@ recheck_relation_needs_vacanalyze(Oid relid,
  *
  * Check whether a relation needs to be vacuumed or analyzed; return each into
  * "dovacuum" and "doanalyze", respectively.  Also return whether the vacuum is
- * being forced because of Xid or multixact wraparound.
+ * being forced because of Xid or multixact wraparound, and a score telling
+ * how urgent the work is.
  *
  * relopts is a pointer to the AutoVacOpts options (either for itself in the
  * case of a plain table, or for either itself or its parent table in the case
@@ -2908,6 +2973,12 @@ recheck_relation_needs_vacanalyze(Oid relid,
  * autovacuum_vacuum_threshold GUC variable.  Similarly, a vac_scale_factor
  * value < 0 is substituted with the value of
  * autovacuum_vacuum_scale_factor GUC variable.  Ditto for analyze.
+ *
+ * The score is the largest of the ratios between each of the quantities
+ * checked above (dead tuples, inserted tuples, modified tuples, relfrozenxid
+ * and relminmxid age) and its threshold.  A table with a score of 1.0 is just
+ * due for processing, while one with a score of 10.0 has accumulated ten
+ * times the work that triggers autovacuum.
  */
 static void
 relation_needs_vacanalyze(Oid relid,
@@ -2918,7 +2989,8 @@ relation_needs_vacanalyze(Oid relid,
  /* output params below */
 						  bool *dovacuum,
 						  bool *doanalyze,
-						  bool *wraparound)
+						  bool *wraparound,
+						  double *score)
 {
 	bool		force_vacuum;
 	bool		av_enabled;
@@ -2952,6 +3024,8 @@ relation_needs_vacanalyze(Oid relid,
 	Assert(classForm != NULL);
 	Assert(OidIsValid(relid));
 
+	*score = 0.0;
+
 	/*
 	 * Determine vacuum/analyze equation parameters.  We have two possible
 	 * sources: the passed reloptions (which could be a main table or a toast
@@ -3013,6 +3087,21 @@ relation_needs_vacanalyze(Oid relid,
 	}
 	*wraparound = force_vacuum;
 
+	/* Score XID and multixact age relative to the freeze limits */
+	if (TransactionIdIsNormal(relfrozenxid) && freeze_max_age > 0)
+	{
+		int32		xid_age = (int32) (recentXid - relfrozenxid);
+
+		*score = Max(*score, (double) xid_age / freeze_max_age);
+	}
+	if (MultiXactIdIsValid(classForm->relminmxid) &&
+		multixact_freeze_max_age > 0)
+	{
+		int32		mxid_age = (int32) (recentMulti - classForm->relminmxid);
+
+		*score = Max(*score, (double) mxid_age / multixact_freeze_max_age);
+	}
+
 	/* User disabled it in pg_class.reloptions?  (But ignore if at risk) */
 	if (!av_enabled && !force_vacuum)
 	{
@@ -3043,19 +3132,32 @@ relation_needs_vacanalyze(Oid relid,
 		vacinsthresh = (float4) vac_ins_base_thresh + vac_ins_scale_factor * reltuples;
 		anlthresh = (float4) anl_base_thresh + anl_scale_factor * reltuples;
 
+		/*
+		 * Score the work relative to the thresholds that trigger it.  Toast
+		 * tables are never analyzed, so their count of modified tuples is
+		 * never reset, and must not count towards their urgency.
+		 */
+		*score = Max(*score, vactuples / Max(vacthresh, 1.0));
+		if (vac_ins_base_thresh >= 0)
+			*score = Max(*score, instuples / Max(vacinsthresh, 1.0));
+		if (relid != StatisticRelationId &&
+			classForm->relkind != RELKIND_TOASTVALUE)
+			*score = Max(*score, anltuples / Max(anlthresh, 1.0));
+
 		/*
 		 * Note that we don't need to take special consideration for stat
 		 * reset, because if that happens, the last vacuum and analyze counts
 		 * will be reset too.
 		 */
 		if (vac_ins_base_thresh >= 0)
-			elog(DEBUG3, "%s: vac: %.0f (threshold %.0f), ins: %.0f (threshold %.0f), anl: %.0f (threshold %.0f)",
+			elog(DEBUG3, "%s: vac: %.0f (threshold %.0f), ins: %.0f (threshold %.0f), anl: %.0f (threshold %.0f), score: %.2f",
 				 NameStr(classForm->relname),
-				 vactuples, vacthresh, instuples, vacinsthresh, anltuples, anlthresh);
+				 vactuples, vacthresh, instuples, vacinsthresh, anltuples, anlthresh,
+				 *score);
 		else
-			elog(DEBUG3, "%s: vac: %.0f (threshold %.0f), ins: (disabled), anl: %.0f (threshold %.0f)",
+			elog(DEBUG3, "%s: vac: %.0f (threshold %.0f), ins: (disabled), anl: %.0f (threshold %.0f), score: %.2f",
 				 NameStr(classForm->relname),
-				 vactuples, vacthresh, anltuples, anlthresh);
+				 vactuples, vacthresh, anltuples, anlthresh, *score);
 
 		/* Determine if this table needs vacuum or analyze. */
 		*dovacuum = force_vacuum || (vactuples > vacthresh) ||
@@ -3400,6 +3400,7 @@ BackendStartup(ClientSocket *client_sock)
 
 	/* Pass down canAcceptConnections state */
 	startup_data.canAcceptConnections = canAcceptConnections(BACKEND_TYPE_NORMAL);
+	startup_data.fork_started = GetCurrentTimestamp();
 	bn->dead_end = (startup_data.canAcceptConnections != CAC_OK);
 	bn->rw = NULL;
 
@@ -624,9 +624,15 @@ libpqrcv_startstreaming(WalReceiverConn *conn,
 		appendStringInfoChar(&cmd, ')');
 	}
 	else
+	{
 		appendStringInfo(&cmd, " TIMELINE %u",
 						 options->proto.physical.startpointTLI);
 
+		if (options->proto.physical.compression != PG_COMPRESSION_NONE)
+			appendStringInfo(&cmd, " (COMPRESSION '%s')",
+							 get_compress_algorithm_name(options->proto.physical.compression));
+	}
+
 	/* Start streaming. */
 	res = libpqrcv_PQexec(conn->streamConn, cmd.data);
 	pfree(cmd.data);
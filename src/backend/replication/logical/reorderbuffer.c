@@ -140,8 +140,24 @@ typedef struct TXNEntryFile
 	File		vfd;			/* -1 when the file is closed */
 	off_t		curOffset;		/* offset for next write or read. Reset to 0
 								 * when vfd is opened. */
+	off_t		prefetchOffset; /* end of the range prefetched so far */
 } TXNEntryFile;
 
+/*
+ * Spilled changes are collected in a buffer of this size and written out
+ * together, rather than with one write() per change, and are prefetched in
+ * chunks of this size when they're read back.
+ */
+#define REORDER_BUFFER_SPILL_BUFSIZE	(128 * 1024)
+
+/* Write buffer for spilling the changes of one transaction to disk */
+typedef struct ReorderBufferSpillBuffer
+{
+	int			fd;				/* spill file being written, or -1 */
+	Size		len;			/* bytes of data not yet written */
+	char	   *data;			/* REORDER_BUFFER_SPILL_BUFSIZE bytes */
+} ReorderBufferSpillBuffer;
+
 /* k-way in-order change iteration support structures */
 typedef struct ReorderBufferIterTXNEntry
 {
@@ -252,7 +268,10 @@ static void ReorderBufferExecuteInvalidations(uint32 nmsgs, SharedInvalidationMe
 static void ReorderBufferCheckMemoryLimit(ReorderBuffer *rb);
 static void ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn);
 static void ReorderBufferSerializeChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
-										 int fd, ReorderBufferChange *change);
+										 ReorderBufferSpillBuffer *buf,
+										 ReorderBufferChange *change);
+static void ReorderBufferSpillFlush(ReorderBufferTXN *txn,
+									ReorderBufferSpillBuffer *buf);
 static Size ReorderBufferRestoreChanges(ReorderBuffer *rb, ReorderBufferTXN *txn,
 										TXNEntryFile *file, XLogSegNo *segno);
 static void ReorderBufferRestoreChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
@@ -3711,7 +3730,7 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 {
 	dlist_iter	subtxn_i;
 	dlist_mutable_iter change_i;
-	int			fd = -1;
+	ReorderBufferSpillBuffer buf;
 	XLogSegNo	curOpenSegNo = 0;
 	Size		spilled = 0;
 	Size		size = txn->size;
@@ -3728,6 +3747,10 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 		ReorderBufferSerializeTXN(rb, subtxn);
 	}
 
+	buf.fd = -1;
+	buf.len = 0;
+	buf.data = NULL;
+
 	/* serialize changestream */
 	dlist_foreach_modify(change_i, &txn->changes)
 	{
@@ -3739,13 +3762,18 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 		 * store in segment in which it belongs by start lsn, don't split over
 		 * multiple segments tho
 		 */
-		if (fd == -1 ||
+		if (buf.fd == -1 ||
 			!XLByteInSeg(change->lsn, curOpenSegNo, wal_segment_size))
 		{
 			char		path[MAXPGPATH];
 
-			if (fd != -1)
-				CloseTransientFile(fd);
+			if (buf.fd != -1)
+			{
+				ReorderBufferSpillFlush(txn, &buf);
+				CloseTransientFile(buf.fd);
+			}
+			else if (buf.data == NULL)
+				buf.data = palloc(REORDER_BUFFER_SPILL_BUFSIZE);
 
 			XLByteToSeg(change->lsn, curOpenSegNo, wal_segment_size);
 
@@ -3757,16 +3785,16 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 										curOpenSegNo);
 
 			/* open segment, create it if necessary */
-			fd = OpenTransientFile(path,
-								   O_CREAT | O_WRONLY | O_APPEND | PG_BINARY);
+			buf.fd = OpenTransientFile(path,
+									   O_CREAT | O_WRONLY | O_APPEND | PG_BINARY);
 
-			if (fd < 0)
+			if (buf.fd < 0)
 				ereport(ERROR,
 						(errcode_for_file_access(),
 						 errmsg("could not open file \"%s\": %m", path)));
 		}
 
-		ReorderBufferSerializeChange(rb, txn, fd, change);
+		ReorderBufferSerializeChange(rb, txn, &buf, change);
 		dlist_delete(&change->node);
 		ReorderBufferReturnChange(rb, change, false);
 
@@ -3794,8 +3822,42 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 	txn->nentries_mem = 0;
 	txn->txn_flags |= RBTXN_IS_SERIALIZED;
 
-	if (fd != -1)
-		CloseTransientFile(fd);
+	if (buf.fd != -1)
+	{
+		ReorderBufferSpillFlush(txn, &buf);
+		CloseTransientFile(buf.fd);
+	}
+	if (buf.data != NULL)
+		pfree(buf.data);
+}
+
+/*
+ * Write out the changes collected in the spill buffer.
+ */
+static void
+ReorderBufferSpillFlush(ReorderBufferTXN *txn, ReorderBufferSpillBuffer *buf)
+{
+	if (buf->len == 0)
+		return;
+
+	errno = 0;
+	pgstat_report_wait_start(WAIT_EVENT_REORDER_BUFFER_WRITE);
+	if (write(buf->fd, buf->data, buf->len) != buf->len)
+	{
+		int			save_errno = errno;
+
+		CloseTransientFile(buf->fd);
+
+		/* if write didn't set errno, assume problem is no disk space */
+		errno = save_errno ? save_errno : ENOSPC;
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not write to data file for XID %u: %m",
+						txn->xid)));
+	}
+	pgstat_report_wait_end();
+
+	buf->len = 0;
 }
 
 /*
@@ -3803,7 +3865,8 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
  */
 static void
 ReorderBufferSerializeChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
-							 int fd, ReorderBufferChange *change)
+							 ReorderBufferSpillBuffer *buf,
+							 ReorderBufferChange *change)
 {
 	ReorderBufferDiskChange *ondisk;
 	Size		sz = sizeof(ReorderBufferDiskChange);
@@ -3984,22 +4047,27 @@ ReorderBufferSerializeChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
 
 	ondisk->size = sz;
 
-	errno = 0;
-	pgstat_report_wait_start(WAIT_EVENT_REORDER_BUFFER_WRITE);
-	if (write(fd, rb->outbuf, ondisk->size) != ondisk->size)
-	{
-		int			save_errno = errno;
+	/*
+	 * Append the change to the spill buffer, making room first if needed.  A
+	 * change too large to be buffered at all is written out directly.
+	 */
+	if (buf->len + sz > REORDER_BUFFER_SPILL_BUFSIZE)
+		ReorderBufferSpillFlush(txn, buf);
 
-		CloseTransientFile(fd);
+	if (sz > REORDER_BUFFER_SPILL_BUFSIZE)
+	{
+		char	   *data = buf->data;
 
-		/* if write didn't set errno, assume problem is no disk space */
-		errno = save_errno ? save_errno : ENOSPC;
-		ereport(ERROR,
-				(errcode_for_file_access(),
-				 errmsg("could not write to data file for XID %u: %m",
-						txn->xid)));
+		buf->data = rb->outbuf;
+		buf->len = sz;
+		ReorderBufferSpillFlush(txn, buf);
+		buf->data = data;
+	}
+	else
+	{
+		memcpy(buf->data + buf->len, rb->outbuf, sz);
+		buf->len += sz;
 	}
-	pgstat_report_wait_end();
 
 	/*
 	 * Keep the transaction's final_lsn up to date with each change we send to
@@ -4305,8 +4373,9 @@ ReorderBufferRestoreChanges(ReorderBuffer *rb, ReorderBufferTXN *txn,
 
 			*fd = PathNameOpenFile(path, O_RDONLY | PG_BINARY);
 
-			/* No harm in resetting the offset even in case of failure */
+			/* No harm in resetting the offsets even in case of failure */
 			file->curOffset = 0;
+			file->prefetchOffset = 0;
 
 			if (*fd < 0 && errno == ENOENT)
 			{
@@ -4321,6 +4390,22 @@ ReorderBufferRestoreChanges(ReorderBuffer *rb, ReorderBufferTXN *txn,
 								path)));
 		}
 
+		/*
+		 * Ask the kernel to start reading the next chunk of the file before
+		 * we get to it, so that restoring a large transaction isn't bound by
+		 * the latency of many small synchronous reads.
+		 */
+		if (file->curOffset + REORDER_BUFFER_SPILL_BUFSIZE / 2 >=
+			file->prefetchOffset)
+		{
+			off_t		start = Max(file->curOffset, file->prefetchOffset);
+
+			(void) FilePrefetch(file->vfd, start,
+								REORDER_BUFFER_SPILL_BUFSIZE,
+								WAIT_EVENT_REORDER_BUFFER_READ);
+			file->prefetchOffset = start + REORDER_BUFFER_SPILL_BUFSIZE;
+		}
+
 		/*
 		 * Read the statically sized part of a change which has information
 		 * about the total size. If we couldn't read a record, we're at the
@@ -1199,6 +1199,7 @@ apply_handle_commit_prepared(StringInfo s)
 	FinishPreparedTransaction(gid, true);
 	end_replication_step();
 	CommitTransactionCommand();
+	pgstat_report_subscription_xact(MySubscription->oid, false);
 	pgstat_report_stat(false);
 
 	store_flush_position(prepare_data.end_lsn, XactLastCommitEnd);
@@ -2261,7 +2262,9 @@ apply_handle_stream_commit(StringInfo s)
 static void
 apply_handle_commit_internal(LogicalRepCommitData *commit_data)
 {
-	if (is_skipping_changes())
+	bool		skipped = is_skipping_changes();
+
+	if (skipped)
 	{
 		stop_skipping_changes();
 
@@ -2296,6 +2299,10 @@ apply_handle_commit_internal(LogicalRepCommitData *commit_data)
 			CommitTransactionCommand();
 		}
 
+		/* Transactions skipped by ALTER SUBSCRIPTION ... SKIP aren't applied */
+		if (!skipped)
+			pgstat_report_subscription_xact(MySubscription->oid,
+											am_parallel_apply_worker());
 		pgstat_report_stat(false);
 
 		store_flush_position(commit_data->end_lsn, XactLastCommitEnd);
@@ -90,7 +90,7 @@ Node *replication_parse_result;
 				create_replication_slot drop_replication_slot
 				alter_replication_slot identify_system read_replication_slot
 				timeline_history show upload_manifest
-%type <list>	generic_option_list
+%type <list>	generic_option_list opt_generic_option_list
 %type <defelt>	generic_option
 %type <uintval>	opt_timeline
 %type <list>	plugin_options plugin_opt_list
@@ -281,10 +281,10 @@ alter_replication_slot:
 			;
 
 /*
- * START_REPLICATION [SLOT slot] [PHYSICAL] %X/%X [TIMELINE %u]
+ * START_REPLICATION [SLOT slot] [PHYSICAL] %X/%X [TIMELINE %u] [(options)]
  */
 start_replication:
-			K_START_REPLICATION opt_slot opt_physical RECPTR opt_timeline
+			K_START_REPLICATION opt_slot opt_physical RECPTR opt_timeline opt_generic_option_list
 				{
 					StartReplicationCmd *cmd;
 
@@ -293,6 +293,7 @@ start_replication:
 					cmd->slotname = $2;
 					cmd->startpoint = $4;
 					cmd->timeline = $5;
+					cmd->options = $6;
 					$$ = (Node *) cmd;
 				}
 			;
@@ -397,6 +398,11 @@ plugin_opt_arg:
 			| /* EMPTY */					{ $$ = NULL; }
 		;
 
+opt_generic_option_list:
+			'(' generic_option_list ')'			{ $$ = $2; }
+			| /* EMPTY */					{ $$ = NIL; }
+			;
+
 generic_option_list:
 			generic_option_list ',' generic_option
 				{ $$ = lappend($1, $3); }
@@ -67,6 +67,7 @@
 #include "postmaster/interrupt.h"
 #include "replication/walreceiver.h"
 #include "replication/walsender.h"
+#include "replication/walstreamcompress.h"
 #include "storage/ipc.h"
 #include "storage/proc.h"
 #include "storage/procarray.h"
@@ -87,6 +88,7 @@
 int			wal_receiver_status_interval;
 int			wal_receiver_timeout;
 bool		hot_standby_feedback;
+int			wal_receiver_compression = PG_COMPRESSION_NONE;
 
 /* libpqwalreceiver connection */
 static WalReceiverConn *wrconn = NULL;
@@ -130,6 +132,13 @@ static TimestampTz wakeup[NUM_WALRCV_WAKEUPS];
 
 static StringInfoData reply_message;
 
+/*
+ * Decompression stream for the WAL data received, if we asked the primary to
+ * compress it, and a buffer for the decompressed data.
+ */
+static WalStreamDecompressor *wal_decompressor = NULL;
+static StringInfoData decompressed_message;
+
 /* Prototypes for private functions */
 static void WalRcvFetchTimeLineHistoryFiles(TimeLineID first, TimeLineID last);
 static void WalRcvWaitForStartPosition(XLogRecPtr *startpoint, TimeLineID *startpointTLI);
@@ -413,6 +422,21 @@ WalReceiverMain(char *startup_data, size_t startup_data_len)
 		options.startpoint = startpoint;
 		options.slotname = slotname[0] != '\0' ? slotname : NULL;
 		options.proto.physical.startpointTLI = startpointTLI;
+
+		/*
+		 * Ask for the stream to be compressed if so configured, and if the
+		 * primary is new enough to understand the request.
+		 */
+		options.proto.physical.compression = PG_COMPRESSION_NONE;
+		if (wal_receiver_compression != PG_COMPRESSION_NONE)
+		{
+			if (walrcv_server_version(wrconn) >= 180000)
+				options.proto.physical.compression = wal_receiver_compression;
+			else if (first_stream)
+				ereport(LOG,
+						(errmsg("WAL stream will not be compressed, the primary server does not support it")));
+		}
+
 		if (walrcv_startstreaming(wrconn, &options))
 		{
 			if (first_stream)
@@ -428,6 +452,12 @@ WalReceiverMain(char *startup_data, size_t startup_data_len)
 			/* Initialize LogstreamResult and buffers for processing messages */
 			LogstreamResult.Write = LogstreamResult.Flush = GetXLogReplayRecPtr(NULL);
 			initStringInfo(&reply_message);
+			if (options.proto.physical.compression != PG_COMPRESSION_NONE)
+			{
+				wal_decompressor =
+					WalStreamDecompressorCreate(options.proto.physical.compression);
+				initStringInfo(&decompressed_message);
+			}
 
 			/* Initialize nap wakeup times. */
 			now = GetCurrentTimestamp();
@@ -614,6 +644,13 @@ WalReceiverMain(char *startup_data, size_t startup_data_len)
 			 */
 			walrcv_endstreaming(wrconn, &primaryTLI);
 
+			if (wal_decompressor != NULL)
+			{
+				WalStreamDecompressorFree(wal_decompressor);
+				wal_decompressor = NULL;
+				pfree(decompressed_message.data);
+			}
+
 			/*
 			 * If the server had switched to a new timeline that we didn't
 			 * know about when we began streaming, fetch its timeline history
@@ -868,6 +905,17 @@ XLogWalRcvProcessMsg(unsigned char type, char *buf, Size len, TimeLineID tli)
 
 				buf += hdrlen;
 				len -= hdrlen;
+
+				/* Decompress the WAL data, if the stream is compressed */
+				if (wal_decompressor != NULL)
+				{
+					resetStringInfo(&decompressed_message);
+					WalStreamDecompress(wal_decompressor, buf, len,
+										&decompressed_message);
+					buf = decompressed_message.data;
+					len = decompressed_message.len;
+				}
+
 				XLogWalRcvWrite(buf, len, dataStart, tli);
 				break;
 			}
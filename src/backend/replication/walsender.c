@@ -78,6 +78,7 @@
 #include "replication/walreceiver.h"
 #include "replication/walsender.h"
 #include "replication/walsender_private.h"
+#include "replication/walstreamcompress.h"
 #include "storage/condition_variable.h"
 #include "storage/fd.h"
 #include "storage/ipc.h"
@@ -169,6 +170,14 @@ static StringInfoData output_message;
 static StringInfoData reply_message;
 static StringInfoData tmpbuf;
 
+/*
+ * Compression stream for the WAL data sent by physical replication, if the
+ * client asked for it in START_REPLICATION, and a buffer for the compressed
+ * messages.
+ */
+static WalStreamCompressor *wal_compressor = NULL;
+static StringInfoData compressed_message;
+
 /* Timestamp of last ProcessRepliesIfAny(). */
 static TimestampTz last_processing = 0;
 
@@ -331,6 +340,12 @@ WalSndErrorCleanup(void)
 	if (xlogreader != NULL && xlogreader->seg.ws_file >= 0)
 		wal_segment_close(xlogreader);
 
+	if (wal_compressor != NULL)
+	{
+		WalStreamCompressorFree(wal_compressor);
+		wal_compressor = NULL;
+	}
+
 	if (MyReplicationSlot != NULL)
 		ReplicationSlotRelease();
 
@@ -779,6 +794,79 @@ HandleUploadManifestPacket(StringInfo buf, off_t *offset,
 	return false;
 }
 
+/*
+ * Process the options of a physical START_REPLICATION command.
+ */
+static void
+parseStartReplicationOptions(StartReplicationCmd *cmd,
+							 pg_compress_specification *compress)
+{
+	ListCell   *lc;
+	bool		compression_given = false;
+	bool		compression_detail_given = false;
+	pg_compress_algorithm algorithm = PG_COMPRESSION_NONE;
+	char	   *compression_detail = NULL;
+	char	   *error_detail;
+
+	foreach(lc, cmd->options)
+	{
+		DefElem    *defel = (DefElem *) lfirst(lc);
+
+		if (strcmp(defel->defname, "compression") == 0)
+		{
+			char	   *optval = defGetString(defel);
+
+			if (compression_given)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("duplicate option \"%s\"", defel->defname)));
+			if (!parse_compress_algorithm(optval, &algorithm))
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("unrecognized compression algorithm: \"%s\"",
+								optval)));
+			compression_given = true;
+		}
+		else if (strcmp(defel->defname, "compression_detail") == 0)
+		{
+			if (compression_detail_given)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("duplicate option \"%s\"", defel->defname)));
+			compression_detail = defGetString(defel);
+			compression_detail_given = true;
+		}
+		else
+			ereport(ERROR,
+					(errcode(ERRCODE_SYNTAX_ERROR),
+					 errmsg("unrecognized option \"%s\" in START_REPLICATION",
+							defel->defname)));
+	}
+
+	if (compression_detail_given && !compression_given)
+		ereport(ERROR,
+				(errcode(ERRCODE_SYNTAX_ERROR),
+				 errmsg("compression detail cannot be specified unless compression is enabled")));
+
+	if (!WalStreamCompressionSupported(algorithm))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("compression algorithm \"%s\" is not supported for WAL streaming",
+						get_compress_algorithm_name(algorithm))));
+
+	parse_compress_specification(algorithm, compression_detail, compress);
+	error_detail = validate_compress_specification(compress);
+	if (error_detail != NULL)
+		ereport(ERROR,
+				errcode(ERRCODE_SYNTAX_ERROR),
+				errmsg("invalid compression specification: %s",
+					   error_detail));
+	if ((compress->options & PG_COMPRESSION_OPTION_WORKERS) != 0)
+		ereport(ERROR,
+				errcode(ERRCODE_SYNTAX_ERROR),
+				errmsg("compression workers are not supported for WAL streaming"));
+}
+
 /*
  * Handle START_REPLICATION command.
  *
@@ -791,6 +879,9 @@ StartReplication(StartReplicationCmd *cmd)
 	StringInfoData buf;
 	XLogRecPtr	FlushPtr;
 	TimeLineID	FlushTLI;
+	pg_compress_specification compress;
+
+	parseStartReplicationOptions(cmd, &compress);
 
 	/* create xlogreader for physical replication */
 	xlogreader =
@@ -941,9 +1032,17 @@ StartReplication(StartReplicationCmd *cmd)
 		/* Start streaming from the requested point */
 		sentPtr = cmd->startpoint;
 
+		/* Set up compression of the stream, if requested */
+		if (compress.algorithm != PG_COMPRESSION_NONE)
+		{
+			wal_compressor = WalStreamCompressorCreate(&compress);
+			initStringInfo(&compressed_message);
+		}
+
 		/* Initialize shared memory status, too */
 		SpinLockAcquire(&MyWalSnd->mutex);
 		MyWalSnd->sentPtr = sentPtr;
+		MyWalSnd->compression = compress.algorithm;
 		SpinLockRelease(&MyWalSnd->mutex);
 
 		SyncRepInitConfig();
@@ -954,6 +1053,13 @@ StartReplication(StartReplicationCmd *cmd)
 		WalSndLoop(XLogSendPhysical);
 
 		replication_active = false;
+
+		if (wal_compressor != NULL)
+		{
+			WalStreamCompressorFree(wal_compressor);
+			wal_compressor = NULL;
+		}
+
 		if (got_STOPPING)
 			proc_exit(0);
 		WalSndSetState(WALSNDSTATE_STARTUP);
@@ -2908,6 +3014,10 @@ InitWalSenderSlot(void)
 			walsnd->applyLag = -1;
 			walsnd->sync_standby_priority = 0;
 			walsnd->replyTime = 0;
+			walsnd->compression = PG_COMPRESSION_NONE;
+			walsnd->compressInBytes = 0;
+			walsnd->compressOutBytes = 0;
+			walsnd->compressTime = 0;
 
 			/*
 			 * The kind assignment is done here and not in StartReplication()
@@ -3044,6 +3154,10 @@ XLogSendPhysical(void)
 	XLogSegNo	segno;
 	WALReadError errinfo;
 	Size		rbytes;
+	StringInfo	msg;
+	uint64		compressInBytes = 0;
+	uint64		compressOutBytes = 0;
+	int64		compressTime = 0;
 
 	/* If requested switch the WAL sender to the stopping state. */
 	if (got_STOPPING)
@@ -3309,15 +3423,42 @@ retry:
 	output_message.len += nbytes;
 	output_message.data[output_message.len] = '\0';
 
+	/*
+	 * If the stream is compressed, send the same header followed by the
+	 * compressed WAL data.
+	 */
+	msg = &output_message;
+	if (wal_compressor != NULL)
+	{
+		int			hdrlen = 1 + sizeof(int64) + sizeof(int64) + sizeof(int64);
+		instr_time	start;
+		instr_time	duration;
+
+		resetStringInfo(&compressed_message);
+		appendBinaryStringInfo(&compressed_message, output_message.data, hdrlen);
+
+		INSTR_TIME_SET_CURRENT(start);
+		WalStreamCompress(wal_compressor, output_message.data + hdrlen,
+						  output_message.len - hdrlen, &compressed_message);
+		INSTR_TIME_SET_CURRENT(duration);
+		INSTR_TIME_SUBTRACT(duration, start);
+
+		compressInBytes = output_message.len - hdrlen;
+		compressOutBytes = compressed_message.len - hdrlen;
+		compressTime = INSTR_TIME_GET_MICROSEC(duration);
+
+		msg = &compressed_message;
+	}
+
 	/*
 	 * Fill the send timestamp last, so that it is taken as late as possible.
 	 */
 	resetStringInfo(&tmpbuf);
 	pq_sendint64(&tmpbuf, GetCurrentTimestamp());
-	memcpy(&output_message.data[1 + sizeof(int64) + sizeof(int64)],
+	memcpy(&msg->data[1 + sizeof(int64) + sizeof(int64)],
 		   tmpbuf.data, sizeof(int64));
 
-	pq_putmessage_noblock('d', output_message.data, output_message.len);
+	pq_putmessage_noblock('d', msg->data, msg->len);
 
 	sentPtr = endptr;
 
@@ -3327,6 +3468,9 @@ retry:
 
 		SpinLockAcquire(&walsnd->mutex);
 		walsnd->sentPtr = sentPtr;
+		walsnd->compressInBytes += compressInBytes;
+		walsnd->compressOutBytes += compressOutBytes;
+		walsnd->compressTime += compressTime;
 		SpinLockRelease(&walsnd->mutex);
 	}
 
@@ -3834,7 +3978,7 @@ offset_to_interval(TimeOffset offset)
 Datum
 pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
 {
-#define PG_STAT_GET_WAL_SENDERS_COLS	12
+#define PG_STAT_GET_WAL_SENDERS_COLS	16
 	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
 	SyncRepStandbyData *sync_standbys;
 	int			num_standbys;
@@ -3862,6 +4006,10 @@ pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
 		int			pid;
 		WalSndState state;
 		TimestampTz replyTime;
+		pg_compress_algorithm compression;
+		uint64		compressInBytes;
+		uint64		compressOutBytes;
+		int64		compressTime;
 		bool		is_sync_standby;
 		Datum		values[PG_STAT_GET_WAL_SENDERS_COLS];
 		bool		nulls[PG_STAT_GET_WAL_SENDERS_COLS] = {0};
@@ -3885,6 +4033,10 @@ pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
 		applyLag = walsnd->applyLag;
 		priority = walsnd->sync_standby_priority;
 		replyTime = walsnd->replyTime;
+		compression = walsnd->compression;
+		compressInBytes = walsnd->compressInBytes;
+		compressOutBytes = walsnd->compressOutBytes;
+		compressTime = walsnd->compressTime;
 		SpinLockRelease(&walsnd->mutex);
 
 		/*
@@ -3981,6 +4133,14 @@ pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
 				nulls[11] = true;
 			else
 				values[11] = TimestampTzGetDatum(replyTime);
+
+			if (compression == PG_COMPRESSION_NONE)
+				nulls[12] = true;
+			else
+				values[12] = CStringGetTextDatum(get_compress_algorithm_name(compression));
+			values[13] = Int64GetDatum((int64) compressInBytes);
+			values[14] = Int64GetDatum((int64) compressOutBytes);
+			values[15] = Float8GetDatum((double) compressTime / 1000.0);
 		}
 
 		tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc,
@@ -0,0 +1,393 @@
+/*-------------------------------------------------------------------------
+ *
+ * walstreamcompress.c
+ *	  Compression of the WAL data sent over physical replication connections.
+ *
+ * When a standby requests it with the COMPRESSION option of
+ * START_REPLICATION, the walsender compresses the payload of each WAL data
+ * message with a compression stream that lives as long as the replication
+ * command, and the walreceiver decompresses it with a matching stream.  The
+ * stream is flushed at the end of every message, so that each message can be
+ * decompressed as soon as it arrives, while later messages still benefit from
+ * the history of earlier ones.
+ *
+ * This compresses only the bytes on the wire: the WAL the standby writes to
+ * disk is identical to what it would have received uncompressed.
+ *
+ * Portions Copyright (c) 2010-2024, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/replication/walstreamcompress.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#ifdef USE_LZ4
+#include <lz4frame.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "access/xlog_internal.h"
+#include "replication/walstreamcompress.h"
+
+#ifdef USE_LZ4
+/*
+ * LZ4F_HEADER_SIZE_MAX first appeared in v1.7.5 of the library.
+ * Redefine it for installations with a lesser version.
+ */
+#ifndef LZ4F_HEADER_SIZE_MAX
+#define LZ4F_HEADER_SIZE_MAX	32
+#endif
+#endif
+
+/*
+ * How much output space to make available for each step of decompression.
+ */
+#define WALSTREAM_DECOMPRESS_CHUNK	(XLOG_BLCKSZ * 4)
+
+struct WalStreamCompressor
+{
+	pg_compress_algorithm algorithm;
+#ifdef USE_LZ4
+	LZ4F_compressionContext_t lz4_ctx;
+	LZ4F_preferences_t lz4_prefs;
+	bool		lz4_begun;		/* frame header emitted? */
+#endif
+#ifdef USE_ZSTD
+	ZSTD_CCtx  *zstd_ctx;
+#endif
+};
+
+struct WalStreamDecompressor
+{
+	pg_compress_algorithm algorithm;
+#ifdef USE_LZ4
+	LZ4F_decompressionContext_t lz4_ctx;
+#endif
+#ifdef USE_ZSTD
+	ZSTD_DCtx  *zstd_ctx;
+#endif
+};
+
+/*
+ * Can WAL streams be compressed with the given algorithm in this build?
+ */
+bool
+WalStreamCompressionSupported(pg_compress_algorithm algorithm)
+{
+	switch (algorithm)
+	{
+		case PG_COMPRESSION_NONE:
+			return true;
+		case PG_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			return true;
+#else
+			return false;
+#endif
+		case PG_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			return true;
+#else
+			return false;
+#endif
+		case PG_COMPRESSION_GZIP:
+			/* no streaming flush support worth having; not offered */
+			return false;
+	}
+
+	return false;				/* keep compiler quiet */
+}
+
+/*
+ * Set up a compression stream according to the given specification.
+ *
+ * The caller is expected to have checked that the algorithm is supported.
+ */
+WalStreamCompressor *
+WalStreamCompressorCreate(pg_compress_specification *spec)
+{
+	WalStreamCompressor *cs;
+
+	Assert(WalStreamCompressionSupported(spec->algorithm));
+	Assert(spec->algorithm != PG_COMPRESSION_NONE);
+
+	cs = palloc0(sizeof(WalStreamCompressor));
+	cs->algorithm = spec->algorithm;
+
+#ifdef USE_LZ4
+	if (spec->algorithm == PG_COMPRESSION_LZ4)
+	{
+		LZ4F_errorCode_t err;
+
+		/*
+		 * Use linked blocks so that each message can refer back to earlier
+		 * ones, and auto-flush so that every message is complete on its own.
+		 */
+		cs->lz4_prefs.frameInfo.blockSizeID = LZ4F_max256KB;
+		cs->lz4_prefs.frameInfo.blockMode = LZ4F_blockLinked;
+		cs->lz4_prefs.compressionLevel = spec->level;
+		cs->lz4_prefs.autoFlush = 1;
+
+		err = LZ4F_createCompressionContext(&cs->lz4_ctx, LZ4F_VERSION);
+		if (LZ4F_isError(err))
+			elog(ERROR, "could not create lz4 compression context: %s",
+				 LZ4F_getErrorName(err));
+	}
+#endif
+#ifdef USE_ZSTD
+	if (spec->algorithm == PG_COMPRESSION_ZSTD)
+	{
+		size_t		ret;
+
+		cs->zstd_ctx = ZSTD_createCCtx();
+		if (!cs->zstd_ctx)
+			elog(ERROR, "could not create zstd compression context");
+
+		ret = ZSTD_CCtx_setParameter(cs->zstd_ctx, ZSTD_c_compressionLevel,
+									 spec->level);
+		if (ZSTD_isError(ret))
+			elog(ERROR, "could not set zstd compression level to %d: %s",
+				 spec->level, ZSTD_getErrorName(ret));
+
+		if ((spec->options & PG_COMPRESSION_OPTION_LONG_DISTANCE) != 0)
+		{
+			ret = ZSTD_CCtx_setParameter(cs->zstd_ctx,
+										 ZSTD_c_enableLongDistanceMatching,
+										 spec->long_distance);
+			if (ZSTD_isError(ret))
+				ereport(ERROR,
+						errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						errmsg("could not enable long-distance mode: %s",
+							   ZSTD_getErrorName(ret)));
+		}
+	}
+#endif
+
+	return cs;
+}
+
+/*
+ * Compress 'len' bytes at 'data', appending the result to 'out'.
+ *
+ * Everything passed in is flushed, so the receiver can decompress all of it
+ * from what has been appended to 'out' so far.
+ */
+void
+WalStreamCompress(WalStreamCompressor *cs, const char *data, size_t len,
+				  StringInfo out)
+{
+#ifdef USE_LZ4
+	if (cs->algorithm == PG_COMPRESSION_LZ4)
+	{
+		size_t		ret;
+
+		if (!cs->lz4_begun)
+		{
+			enlargeStringInfo(out, LZ4F_HEADER_SIZE_MAX);
+			ret = LZ4F_compressBegin(cs->lz4_ctx, out->data + out->len,
+									 out->maxlen - out->len - 1,
+									 &cs->lz4_prefs);
+			if (LZ4F_isError(ret))
+				elog(ERROR, "could not write lz4 header: %s",
+					 LZ4F_getErrorName(ret));
+			out->len += ret;
+			cs->lz4_begun = true;
+		}
+
+		enlargeStringInfo(out, LZ4F_compressBound(len, &cs->lz4_prefs));
+		ret = LZ4F_compressUpdate(cs->lz4_ctx, out->data + out->len,
+								  out->maxlen - out->len - 1, data, len, NULL);
+		if (LZ4F_isError(ret))
+			elog(ERROR, "could not compress data: %s",
+				 LZ4F_getErrorName(ret));
+		out->len += ret;
+		out->data[out->len] = '\0';
+		return;
+	}
+#endif
+#ifdef USE_ZSTD
+	if (cs->algorithm == PG_COMPRESSION_ZSTD)
+	{
+		ZSTD_inBuffer inbuf = {data, len, 0};
+		size_t		yet_to_flush;
+
+		do
+		{
+			ZSTD_outBuffer outbuf;
+
+			enlargeStringInfo(out, ZSTD_compressBound(inbuf.size - inbuf.pos));
+			outbuf.dst = out->data + out->len;
+			outbuf.size = out->maxlen - out->len - 1;
+			outbuf.pos = 0;
+
+			yet_to_flush = ZSTD_compressStream2(cs->zstd_ctx, &outbuf, &inbuf,
+												ZSTD_e_flush);
+			if (ZSTD_isError(yet_to_flush))
+				elog(ERROR, "could not compress data: %s",
+					 ZSTD_getErrorName(yet_to_flush));
+			out->len += outbuf.pos;
+		} while (yet_to_flush > 0 || inbuf.pos < inbuf.size);
+
+		out->data[out->len] = '\0';
+		return;
+	}
+#endif
+
+	elog(ERROR, "unsupported WAL stream compression algorithm %d",
+		 (int) cs->algorithm);
+}
+
+/*
+ * Release a compression stream.
+ */
+void
+WalStreamCompressorFree(WalStreamCompressor *cs)
+{
+#ifdef USE_LZ4
+	if (cs->algorithm == PG_COMPRESSION_LZ4)
+		LZ4F_freeCompressionContext(cs->lz4_ctx);
+#endif
+#ifdef USE_ZSTD
+	if (cs->algorithm == PG_COMPRESSION_ZSTD)
+		ZSTD_freeCCtx(cs->zstd_ctx);
+#endif
+	pfree(cs);
+}
+
+/*
+ * Set up a decompression stream for the given algorithm.
+ *
+ * The caller is expected to have checked that the algorithm is supported.
+ */
+WalStreamDecompressor *
+WalStreamDecompressorCreate(pg_compress_algorithm algorithm)
+{
+	WalStreamDecompressor *ds;
+
+	Assert(WalStreamCompressionSupported(algorithm));
+	Assert(algorithm != PG_COMPRESSION_NONE);
+
+	ds = palloc0(sizeof(WalStreamDecompressor));
+	ds->algorithm = algorithm;
+
+#ifdef USE_LZ4
+	if (algorithm == PG_COMPRESSION_LZ4)
+	{
+		LZ4F_errorCode_t err;
+
+		err = LZ4F_createDecompressionContext(&ds->lz4_ctx, LZ4F_VERSION);
+		if (LZ4F_isError(err))
+			elog(ERROR, "could not create lz4 decompression context: %s",
+				 LZ4F_getErrorName(err));
+	}
+#endif
+#ifdef USE_ZSTD
+	if (algorithm == PG_COMPRESSION_ZSTD)
+	{
+		ds->zstd_ctx = ZSTD_createDCtx();
+		if (!ds->zstd_ctx)
+			elog(ERROR, "could not create zstd decompression context");
+	}
+#endif
+
+	return ds;
+}
+
+/*
+ * Decompress 'len' bytes at 'data', appending the result to 'out'.
+ *
+ * We keep going as long as there is input left, or the decompressor filled
+ * all the output space we gave it and so may have more to hand out.
+ */
+void
+WalStreamDecompress(WalStreamDecompressor *ds, const char *data, size_t len,
+					StringInfo out)
+{
+#ifdef USE_LZ4
+	if (ds->algorithm == PG_COMPRESSION_LZ4)
+	{
+		size_t		consumed = 0;
+		bool		output_full;
+
+		do
+		{
+			size_t		in_size = len - consumed;
+			size_t		out_size;
+			size_t		ret;
+
+			enlargeStringInfo(out, WALSTREAM_DECOMPRESS_CHUNK);
+			out_size = out->maxlen - out->len - 1;
+
+			ret = LZ4F_decompress(ds->lz4_ctx, out->data + out->len, &out_size,
+								  data + consumed, &in_size, NULL);
+			if (LZ4F_isError(ret))
+				ereport(ERROR,
+						(errcode(ERRCODE_PROTOCOL_VIOLATION),
+						 errmsg("could not decompress WAL data received from primary: %s",
+								LZ4F_getErrorName(ret))));
+
+			output_full = (out_size == out->maxlen - out->len - 1);
+			out->len += out_size;
+			consumed += in_size;
+		} while (consumed < len || output_full);
+
+		out->data[out->len] = '\0';
+		return;
+	}
+#endif
+#ifdef USE_ZSTD
+	if (ds->algorithm == PG_COMPRESSION_ZSTD)
+	{
+		ZSTD_inBuffer inbuf = {data, len, 0};
+		bool		output_full;
+
+		do
+		{
+			ZSTD_outBuffer outbuf;
+			size_t		ret;
+
+			enlargeStringInfo(out, WALSTREAM_DECOMPRESS_CHUNK);
+			outbuf.dst = out->data + out->len;
+			outbuf.size = out->maxlen - out->len - 1;
+			outbuf.pos = 0;
+
+			ret = ZSTD_decompressStream(ds->zstd_ctx, &outbuf, &inbuf);
+			if (ZSTD_isError(ret))
+				ereport(ERROR,
+						(errcode(ERRCODE_PROTOCOL_VIOLATION),
+						 errmsg("could not decompress WAL data received from primary: %s",
+								ZSTD_getErrorName(ret))));
+
+			output_full = (outbuf.pos == outbuf.size);
+			out->len += outbuf.pos;
+		} while (inbuf.pos < inbuf.size || output_full);
+
+		out->data[out->len] = '\0';
+		return;
+	}
+#endif
+
+	elog(ERROR, "unsupported WAL stream compression algorithm %d",
+		 (int) ds->algorithm);
+}
+
+/*
+ * Release a decompression stream.
+ */
+void
+WalStreamDecompressorFree(WalStreamDecompressor *ds)
+{
+#ifdef USE_LZ4
+	if (ds->algorithm == PG_COMPRESSION_LZ4)
+		LZ4F_freeDecompressionContext(ds->lz4_ctx);
+#endif
+#ifdef USE_ZSTD
+	if (ds->algorithm == PG_COMPRESSION_ZSTD)
+		ZSTD_freeDCtx(ds->zstd_ctx);
+#endif
+	pfree(ds);
+}
@@ -38,10 +38,13 @@
 #include "utils/memutils.h"
 #include "utils/ps_status.h"
 #include "utils/timeout.h"
+#include "utils/timestamp.h"
 
 /* GUCs */
 bool		Trace_connection_negotiation = false;
 
+ConnectionTiming conn_timing = {0};
+
 static void BackendInitialize(ClientSocket *client_sock, CAC_state cac);
 static int	ProcessSSLStartup(Port *port);
 static int	ProcessStartupPacket(Port *port, bool ssl_done, bool gss_done);
@@ -63,6 +66,9 @@ BackendMain(char *startup_data, size_t startup_data_len)
 	Assert(startup_data_len == sizeof(BackendStartupData));
 	Assert(MyClientSocket != NULL);
 
+	conn_timing.fork_start = bsdata->fork_started;
+	conn_timing.fork_end = GetCurrentTimestamp();
+
 #ifdef EXEC_BACKEND
 
 	/*
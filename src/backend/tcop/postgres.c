@@ -66,6 +66,7 @@
 #include "storage/proc.h"
 #include "storage/procsignal.h"
 #include "storage/sinval.h"
+#include "tcop/backend_startup.h"
 #include "tcop/fastpath.h"
 #include "tcop/pquery.h"
 #include "tcop/tcopprot.h"
@@ -4396,6 +4397,21 @@ PostgresMain(const char *dbname, const char *username)
 		/* Need not flush since ReadyForQuery will do it. */
 	}
 
+	/*
+	 * Connection setup is complete.  Report how long its stages took, if
+	 * wanted.
+	 */
+	if (Log_connections && conn_timing.fork_start != 0)
+	{
+		TimestampTz now = GetCurrentTimestamp();
+
+		ereport(LOG,
+				errmsg("connection ready: setup total=%.3f ms, fork=%.3f ms, authentication=%.3f ms",
+					   (double) (now - conn_timing.fork_start) / 1000.0,
+					   (double) (conn_timing.fork_end - conn_timing.fork_start) / 1000.0,
+					   (double) (conn_timing.auth_end - conn_timing.auth_start) / 1000.0));
+	}
+
 	/* Welcome banner for standalone case */
 	if (whereToSendOutput == DestDebug)
 		printf("\nPostgreSQL stand-alone backend %s\n", PG_VERSION);
@@ -34,6 +34,8 @@
  */
 #define NumBackendStatSlots (MaxBackends + NUM_AUXILIARY_PROCS)
 
+#define UINT32_ACCESS_ONCE(var)		 ((uint32)(*((volatile uint32 *)&(var))))
+
 
 /* ----------
  * GUC parameters
@@ -1134,6 +1136,70 @@ pgstat_get_local_beentry_by_index(int idx)
 }
 
 
+/* ----------
+ * pgstat_get_backend_sample() -
+ *
+ *	Copy what the backend with the given ProcNumber is currently doing into
+ *	*sample, or return false if no backend is using that slot.
+ *
+ *	Unlike the functions above, this reads the shared status array directly
+ *	instead of building a local snapshot of all entries (including their
+ *	activity strings), so it's cheap enough to be called for every backend
+ *	at a high frequency, e.g. by a sampling profiler.  Consecutive calls see
+ *	different points in time.
+ *
+ *	NB: caller is responsible for checking if the user is permitted to see
+ *	this info.
+ * ----------
+ */
+bool
+pgstat_get_backend_sample(ProcNumber procNumber, PgBackendSample *sample)
+{
+	volatile PgBackendStatus *vbeentry;
+
+	if (procNumber < 0 || procNumber >= NumBackendStatSlots)
+		return false;
+
+	vbeentry = &BackendStatusArray[procNumber];
+
+	for (;;)
+	{
+		int			before_changecount;
+		int			after_changecount;
+
+		pgstat_begin_read_activity(vbeentry, before_changecount);
+
+		sample->pid = vbeentry->st_procpid;
+		sample->backendType = vbeentry->st_backendType;
+		sample->databaseid = vbeentry->st_databaseid;
+		sample->userid = vbeentry->st_userid;
+		sample->state = vbeentry->st_state;
+		sample->query_id = vbeentry->st_query_id;
+
+		pgstat_end_read_activity(vbeentry, after_changecount);
+
+		if (pgstat_read_activity_complete(before_changecount,
+										  after_changecount))
+			break;
+
+		/* Make sure we can break out of loop if stuck... */
+		CHECK_FOR_INTERRUPTS();
+	}
+
+	if (sample->pid <= 0)
+		return false;
+
+	/*
+	 * The wait event is read without any lock, the same way as for
+	 * pg_stat_activity.
+	 */
+	sample->wait_event_info =
+		UINT32_ACCESS_ONCE(GetPGProcByNumber(procNumber)->wait_event_info);
+
+	return true;
+}
+
+
 /* ----------
  * pgstat_fetch_stat_numbackends() -
  *
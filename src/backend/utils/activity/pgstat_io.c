@@ -25,6 +25,7 @@ typedef struct PgStat_PendingIO
 {
 	PgStat_Counter counts[IOOBJECT_NUM_TYPES][IOCONTEXT_NUM_TYPES][IOOP_NUM_TYPES];
 	instr_time	pending_times[IOOBJECT_NUM_TYPES][IOCONTEXT_NUM_TYPES][IOOP_NUM_TYPES];
+	PgStat_LatencyHist hists[IOOBJECT_NUM_TYPES][IOCONTEXT_NUM_TYPES][IOOP_NUM_TYPES];
 } PgStat_PendingIO;
 
 
@@ -148,6 +149,8 @@ pgstat_count_io_op_time(IOObject io_object, IOContext io_context, IOOp io_op,
 
 		INSTR_TIME_ADD(PendingIOStats.pending_times[io_object][io_context][io_op],
 					   io_time);
+		PendingIOStats.hists[io_object][io_context][io_op]
+			[pgstat_latency_hist_bucket(io_time)]++;
 	}
 
 	pgstat_count_io_op_n(io_object, io_context, io_op, cnt);
@@ -220,6 +223,10 @@ pgstat_io_flush_cb(bool nowait)
 
 				bktype_shstats->times[io_object][io_context][io_op] +=
 					INSTR_TIME_GET_MICROSEC(time);
+
+				for (int bucket = 0; bucket < PGSTAT_LATENCY_HIST_BUCKETS; bucket++)
+					bktype_shstats->hists[io_object][io_context][io_op][bucket] +=
+						PendingIOStats.hists[io_object][io_context][io_op][bucket];
 			}
 		}
 	}
@@ -269,6 +276,33 @@ pgstat_get_io_object_name(IOObject io_object)
 	pg_unreachable();
 }
 
+const char *
+pgstat_get_io_op_name(IOOp io_op)
+{
+	switch (io_op)
+	{
+		case IOOP_EVICT:
+			return "evict";
+		case IOOP_EXTEND:
+			return "extend";
+		case IOOP_FSYNC:
+			return "fsync";
+		case IOOP_HIT:
+			return "hit";
+		case IOOP_READ:
+			return "read";
+		case IOOP_REUSE:
+			return "reuse";
+		case IOOP_WRITE:
+			return "write";
+		case IOOP_WRITEBACK:
+			return "writeback";
+	}
+
+	elog(ERROR, "unrecognized IOOp value: %d", io_op);
+	pg_unreachable();
+}
+
 void
 pgstat_io_init_shmem_cb(void *stats)
 {
@@ -41,12 +41,21 @@ typedef struct TwoPhasePgStatRecord
 	bool		truncdropped;	/* was the relation truncated/dropped? */
 } TwoPhasePgStatRecord;
 
+/* Context for pgstat_scan_stat_tabentries() */
+typedef struct ScanTabEntriesContext
+{
+	pgstat_tabentry_callback callback;
+	void	   *arg;
+} ScanTabEntriesContext;
+
 
 static PgStat_TableStatus *pgstat_prep_relation_pending(Oid rel_id, bool isshared);
 static void add_tabstat_xact_level(PgStat_TableStatus *pgstat_info, int nest_level);
 static void ensure_tabstat_xact_level(PgStat_TableStatus *pgstat_info);
 static void save_truncdrop_counters(PgStat_TableXactStatus *trans, bool is_drop);
 static void restore_truncdrop_counters(PgStat_TableXactStatus *trans);
+static void scan_stat_tabentries_cb(const PgStat_HashKey *key,
+									const void *stats, void *arg);
 
 
 /*
@@ -470,6 +479,36 @@ pgstat_fetch_stat_tabentry_ext(bool shared, Oid reloid)
 		pgstat_fetch_entry(PGSTAT_KIND_RELATION, dboid, reloid);
 }
 
+/*
+ * Passes the statistics of every table and index of the current database,
+ * and of every shared relation, to callback.
+ *
+ * This reads the shared statistics directly, without building a snapshot
+ * (regardless of stats_fetch_consistency), so it is much cheaper than
+ * fetching the entries one by one when all of them are wanted.
+ */
+void
+pgstat_scan_stat_tabentries(pgstat_tabentry_callback callback, void *arg)
+{
+	ScanTabEntriesContext ctx;
+
+	ctx.callback = callback;
+	ctx.arg = arg;
+
+	pgstat_scan_entries_of_kind(PGSTAT_KIND_RELATION,
+								scan_stat_tabentries_cb, &ctx);
+}
+
+static void
+scan_stat_tabentries_cb(const PgStat_HashKey *key, const void *stats,
+						void *arg)
+{
+	ScanTabEntriesContext *ctx = (ScanTabEntriesContext *) arg;
+
+	ctx->callback((Oid) key->objid, key->dboid == InvalidOid,
+				  (const PgStat_StatTabEntry *) stats, ctx->arg);
+}
+
 /*
  * find any existing PgStat_TableStatus entry for rel
  *
@@ -1044,6 +1044,82 @@ pgstat_reset_matching_entries(bool (*do_reset) (PgStatShared_HashEntry *, Datum)
 	dshash_seq_term(&hstat);
 }
 
+/*
+ * Scan through the shared hashtable of stats, calling callback with a copy of
+ * the statistics of each entry of the given kind that is visible from the
+ * current database.
+ *
+ * Unlike building a snapshot, this doesn't build a hash table of the entries,
+ * so the cost of reading all entries of a kind stays linear in their number.
+ * Each entry is copied while holding its lock, so the callback sees a
+ * consistent set of counters for one object, but there's no consistency
+ * across objects.  The matching entries are first copied into a local array
+ * and the callback is invoked only after the scan of the hashtable has
+ * finished, so that it doesn't run while holding a partition lock, which
+ * would block stats flushes and entry creation in other backends.
+ */
+void
+pgstat_scan_entries_of_kind(PgStat_Kind kind,
+							void (*callback) (const PgStat_HashKey *key,
+											  const void *stats,
+											  void *arg),
+							void *arg)
+{
+	const PgStat_KindInfo *kind_info = pgstat_get_kind_info(kind);
+	size_t		data_len = kind_info->shared_data_len;
+	dshash_seq_status hstat;
+	PgStatShared_HashEntry *p;
+	PgStat_HashKey *keys;
+	char	   *data;
+	size_t		nentries = 0;
+	size_t		maxentries = 64;
+
+	Assert(!kind_info->fixed_amount);
+
+	keys = palloc(sizeof(PgStat_HashKey) * maxentries);
+	data = palloc(data_len * maxentries);
+
+	/* dshash entry is not modified, take shared lock */
+	dshash_seq_init(&hstat, pgStatLocal.shared_hash, false);
+	while ((p = dshash_seq_next(&hstat)) != NULL)
+	{
+		PgStatShared_Common *header;
+
+		if (p->key.kind != kind || p->dropped)
+			continue;
+
+		/* same visibility rule as for snapshots, see pgstat_build_snapshot */
+		if (p->key.dboid != MyDatabaseId &&
+			p->key.dboid != InvalidOid &&
+			!kind_info->accessed_across_databases)
+			continue;
+
+		if (nentries >= maxentries)
+		{
+			maxentries *= 2;
+			keys = repalloc_huge(keys, sizeof(PgStat_HashKey) * maxentries);
+			data = repalloc_huge(data, data_len * maxentries);
+		}
+
+		header = dsa_get_address(pgStatLocal.dsa, p->body);
+
+		keys[nentries] = p->key;
+		LWLockAcquire(&header->lock, LW_SHARED);
+		memcpy(data + nentries * data_len,
+			   pgstat_get_entry_data(kind, header),
+			   data_len);
+		LWLockRelease(&header->lock);
+		nentries++;
+	}
+	dshash_seq_term(&hstat);
+
+	for (size_t i = 0; i < nentries; i++)
+		callback(&keys[i], data + i * data_len, arg);
+
+	pfree(keys);
+	pfree(data);
+}
+
 static bool
 match_kind(PgStatShared_HashEntry *p, Datum match_data)
 {
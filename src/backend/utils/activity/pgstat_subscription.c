@@ -54,6 +54,24 @@ pgstat_report_subscription_conflict(Oid subid, ConflictType type)
 	pending->conflict_count[type]++;
 }
 
+/*
+ * Report a remote transaction applied by the subscription, either by the
+ * leader apply worker or by a parallel apply worker.
+ */
+void
+pgstat_report_subscription_xact(Oid subid, bool parallel)
+{
+	PgStat_EntryRef *entry_ref;
+	PgStat_BackendSubEntry *pending;
+
+	entry_ref = pgstat_prep_pending_entry(PGSTAT_KIND_SUBSCRIPTION,
+										  InvalidOid, subid, NULL);
+	pending = entry_ref->pending;
+	pending->apply_xact_count++;
+	if (parallel)
+		pending->parallel_apply_xact_count++;
+}
+
 /*
  * Report creating the subscription.
  */
@@ -118,6 +136,8 @@ pgstat_subscription_flush_cb(PgStat_EntryRef *entry_ref, bool nowait)
 	SUB_ACC(sync_error_count);
 	for (int i = 0; i < CONFLICT_NUM_TYPES; i++)
 		SUB_ACC(conflict_count[i]);
+	SUB_ACC(apply_xact_count);
+	SUB_ACC(parallel_apply_xact_count);
 #undef SUB_ACC
 
 	pgstat_unlock_entry(entry_ref);
@@ -128,6 +128,11 @@ pgstat_wal_flush_cb(bool nowait)
 	WALSTAT_ACC(wal_sync, PendingWalStats);
 	WALSTAT_ACC_INSTR_TIME(wal_write_time);
 	WALSTAT_ACC_INSTR_TIME(wal_sync_time);
+	for (int bucket = 0; bucket < PGSTAT_LATENCY_HIST_BUCKETS; bucket++)
+	{
+		WALSTAT_ACC(wal_write_hist[bucket], PendingWalStats);
+		WALSTAT_ACC(wal_sync_hist[bucket], PendingWalStats);
+	}
 #undef WALSTAT_ACC_INSTR_TIME
 #undef WALSTAT_ACC
 
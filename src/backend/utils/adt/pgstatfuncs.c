@@ -140,6 +140,81 @@ PG_STAT_GET_RELENTRY_TIMESTAMPTZ(last_vacuum_time)
 /* pg_stat_get_lastscan */
 PG_STAT_GET_RELENTRY_TIMESTAMPTZ(lastscan)
 
+#define PG_STAT_GET_RELATION_STATS_COLS	25
+
+/*
+ * Callback for pg_stat_get_relation_stats(), adding one row to the result.
+ */
+static void
+pg_stat_get_relation_stats_cb(Oid reloid, bool shared,
+							  const PgStat_StatTabEntry *tabentry, void *arg)
+{
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) arg;
+	Datum		values[PG_STAT_GET_RELATION_STATS_COLS] = {0};
+	bool		nulls[PG_STAT_GET_RELATION_STATS_COLS] = {0};
+	int			i = 0;
+
+#define REL_STATS_TIMESTAMPTZ(ts) \
+	do { \
+		if ((ts) == 0) \
+			nulls[i++] = true; \
+		else \
+			values[i++] = TimestampTzGetDatum(ts); \
+	} while (0)
+
+	values[i++] = ObjectIdGetDatum(reloid);
+	values[i++] = BoolGetDatum(shared);
+	values[i++] = Int64GetDatum(tabentry->numscans);
+	REL_STATS_TIMESTAMPTZ(tabentry->lastscan);
+	values[i++] = Int64GetDatum(tabentry->tuples_returned);
+	values[i++] = Int64GetDatum(tabentry->tuples_fetched);
+	values[i++] = Int64GetDatum(tabentry->tuples_inserted);
+	values[i++] = Int64GetDatum(tabentry->tuples_updated);
+	values[i++] = Int64GetDatum(tabentry->tuples_deleted);
+	values[i++] = Int64GetDatum(tabentry->tuples_hot_updated);
+	values[i++] = Int64GetDatum(tabentry->tuples_newpage_updated);
+	values[i++] = Int64GetDatum(tabentry->live_tuples);
+	values[i++] = Int64GetDatum(tabentry->dead_tuples);
+	values[i++] = Int64GetDatum(tabentry->mod_since_analyze);
+	values[i++] = Int64GetDatum(tabentry->ins_since_vacuum);
+	values[i++] = Int64GetDatum(tabentry->blocks_fetched);
+	values[i++] = Int64GetDatum(tabentry->blocks_hit);
+	REL_STATS_TIMESTAMPTZ(tabentry->last_vacuum_time);
+	values[i++] = Int64GetDatum(tabentry->vacuum_count);
+	REL_STATS_TIMESTAMPTZ(tabentry->last_autovacuum_time);
+	values[i++] = Int64GetDatum(tabentry->autovacuum_count);
+	REL_STATS_TIMESTAMPTZ(tabentry->last_analyze_time);
+	values[i++] = Int64GetDatum(tabentry->analyze_count);
+	REL_STATS_TIMESTAMPTZ(tabentry->last_autoanalyze_time);
+	values[i++] = Int64GetDatum(tabentry->autoanalyze_count);
+
+#undef REL_STATS_TIMESTAMPTZ
+
+	Assert(i == PG_STAT_GET_RELATION_STATS_COLS);
+
+	tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc, values, nulls);
+}
+
+/*
+ * Returns the statistics of all tables and indexes of the current database
+ * and of all shared relations in one pass over the shared statistics.
+ *
+ * This is meant for monitoring tools that collect statistics of all
+ * relations at once.  Calling the per-relation functions for every relation
+ * looks up each entry separately (and may build a snapshot of all
+ * statistics first), while this reads the entries in place.
+ */
+Datum
+pg_stat_get_relation_stats(PG_FUNCTION_ARGS)
+{
+	InitMaterializedSRF(fcinfo, 0);
+
+	pgstat_scan_stat_tabentries(pg_stat_get_relation_stats_cb,
+								fcinfo->resultinfo);
+
+	return (Datum) 0;
+}
+
 Datum
 pg_stat_get_function_calls(PG_FUNCTION_ARGS)
 {
@@ -1480,6 +1555,93 @@ pg_stat_get_io(PG_FUNCTION_ARGS)
 	return (Datum) 0;
 }
 
+/*
+ * Fill in the bucket bounds of a latency histogram row, in microseconds.  The
+ * upper bound is exclusive, and NULL for the last, open-ended bucket.
+ */
+static void
+pg_stat_latency_bucket_bounds(int bucket, Datum *lower, Datum *upper,
+							  bool *upper_isnull)
+{
+	*lower = Int64GetDatum(bucket == 0 ? 0 :
+						   (int64) PGSTAT_LATENCY_HIST_MIN_US << (bucket - 1));
+	if (bucket == PGSTAT_LATENCY_HIST_BUCKETS - 1)
+		*upper_isnull = true;
+	else
+		*upper = Int64GetDatum((int64) PGSTAT_LATENCY_HIST_MIN_US << bucket);
+}
+
+/*
+ * Returns the IO latency histograms, one row per bucket for each timed IOOp
+ * shown in pg_stat_io.
+ */
+Datum
+pg_stat_get_io_histogram(PG_FUNCTION_ARGS)
+{
+#define PG_STAT_GET_IO_HIST_COLS	8
+	ReturnSetInfo *rsinfo;
+	PgStat_IO  *backends_io_stats;
+	Datum		reset_time;
+
+	InitMaterializedSRF(fcinfo, 0);
+	rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+
+	backends_io_stats = pgstat_fetch_stat_io();
+
+	reset_time = TimestampTzGetDatum(backends_io_stats->stat_reset_timestamp);
+
+	for (int bktype = 0; bktype < BACKEND_NUM_TYPES; bktype++)
+	{
+		Datum		bktype_desc = CStringGetTextDatum(GetBackendTypeDesc(bktype));
+		PgStat_BktypeIO *bktype_stats = &backends_io_stats->stats[bktype];
+
+		if (!pgstat_tracks_io_bktype(bktype))
+			continue;
+
+		for (int io_obj = 0; io_obj < IOOBJECT_NUM_TYPES; io_obj++)
+		{
+			Datum		obj_name = CStringGetTextDatum(pgstat_get_io_object_name(io_obj));
+
+			for (int io_context = 0; io_context < IOCONTEXT_NUM_TYPES; io_context++)
+			{
+				Datum		context_name = CStringGetTextDatum(pgstat_get_io_context_name(io_context));
+
+				for (int io_op = 0; io_op < IOOP_NUM_TYPES; io_op++)
+				{
+					Datum		op_name;
+
+					/* only show operations that pg_stat_io shows a time for */
+					if (pgstat_get_io_time_index(io_op) == IO_COL_INVALID ||
+						!pgstat_tracks_io_op(bktype, io_obj, io_context, io_op))
+						continue;
+
+					op_name = CStringGetTextDatum(pgstat_get_io_op_name(io_op));
+
+					for (int bucket = 0; bucket < PGSTAT_LATENCY_HIST_BUCKETS; bucket++)
+					{
+						Datum		values[PG_STAT_GET_IO_HIST_COLS] = {0};
+						bool		nulls[PG_STAT_GET_IO_HIST_COLS] = {0};
+
+						values[0] = bktype_desc;
+						values[1] = obj_name;
+						values[2] = context_name;
+						values[3] = op_name;
+						pg_stat_latency_bucket_bounds(bucket, &values[4],
+													  &values[5], &nulls[5]);
+						values[6] = Int64GetDatum(bktype_stats->hists[io_obj][io_context][io_op][bucket]);
+						values[7] = reset_time;
+
+						tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc,
+											 values, nulls);
+					}
+				}
+			}
+		}
+	}
+
+	return (Datum) 0;
+}
+
 /*
  * Returns statistics of WAL activity
  */
@@ -1544,6 +1706,46 @@ pg_stat_get_wal(PG_FUNCTION_ARGS)
 	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
 }
 
+/*
+ * Returns the WAL write and sync latency histograms.
+ */
+Datum
+pg_stat_get_wal_histogram(PG_FUNCTION_ARGS)
+{
+#define PG_STAT_GET_WAL_HIST_COLS	5
+	ReturnSetInfo *rsinfo;
+	PgStat_WalStats *wal_stats;
+
+	InitMaterializedSRF(fcinfo, 0);
+	rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+
+	wal_stats = pgstat_fetch_stat_wal();
+
+	for (int i = 0; i < 2; i++)
+	{
+		const char *op_name = (i == 0) ? "write" : "sync";
+		PgStat_Counter *hist = (i == 0) ?
+			wal_stats->wal_write_hist : wal_stats->wal_sync_hist;
+
+		for (int bucket = 0; bucket < PGSTAT_LATENCY_HIST_BUCKETS; bucket++)
+		{
+			Datum		values[PG_STAT_GET_WAL_HIST_COLS] = {0};
+			bool		nulls[PG_STAT_GET_WAL_HIST_COLS] = {0};
+
+			values[0] = CStringGetTextDatum(op_name);
+			pg_stat_latency_bucket_bounds(bucket, &values[1],
+										  &values[2], &nulls[2]);
+			values[3] = Int64GetDatum(hist[bucket]);
+			values[4] = TimestampTzGetDatum(wal_stats->stat_reset_timestamp);
+
+			tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc,
+								 values, nulls);
+		}
+	}
+
+	return (Datum) 0;
+}
+
 /*
  * Returns statistics of SLRU caches.
  */
@@ -1984,7 +2186,7 @@ pg_stat_get_replication_slot(PG_FUNCTION_ARGS)
 Datum
 pg_stat_get_subscription_stats(PG_FUNCTION_ARGS)
 {
-#define PG_STAT_GET_SUBSCRIPTION_STATS_COLS	10
+#define PG_STAT_GET_SUBSCRIPTION_STATS_COLS	12
 	Oid			subid = PG_GETARG_OID(0);
 	TupleDesc	tupdesc;
 	Datum		values[PG_STAT_GET_SUBSCRIPTION_STATS_COLS] = {0};
@@ -2016,7 +2218,11 @@ pg_stat_get_subscription_stats(PG_FUNCTION_ARGS)
 					   INT8OID, -1, 0);
 	TupleDescInitEntry(tupdesc, (AttrNumber) 9, "confl_delete_missing",
 					   INT8OID, -1, 0);
-	TupleDescInitEntry(tupdesc, (AttrNumber) 10, "stats_reset",
+	TupleDescInitEntry(tupdesc, (AttrNumber) 10, "apply_xact_count",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 11, "parallel_apply_xact_count",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 12, "stats_reset",
 					   TIMESTAMPTZOID, -1, 0);
 	BlessTupleDesc(tupdesc);
 
@@ -2040,6 +2246,12 @@ pg_stat_get_subscription_stats(PG_FUNCTION_ARGS)
 	for (int nconflict = 0; nconflict < CONFLICT_NUM_TYPES; nconflict++)
 		values[i++] = Int64GetDatum(subentry->conflict_count[nconflict]);
 
+	/* apply_xact_count */
+	values[i++] = Int64GetDatum(subentry->apply_xact_count);
+
+	/* parallel_apply_xact_count */
+	values[i++] = Int64GetDatum(subentry->parallel_apply_xact_count);
+
 	/* stats_reset */
 	if (subentry->stat_reset_timestamp == 0)
 		nulls[i] = true;
@@ -143,11 +143,71 @@
 
 #define DEFAULT_PAGE_CPU_MULTIPLIER 50.0
 
+/*
+ * Minimum number of array elements for which scalararraysel() estimates an
+ * eqsel()/neqsel() ScalarArrayOpExpr in a single pass over the statistics,
+ * rather than invoking the estimator separately for each element.  This is
+ * the same cutoff the planner uses for hashed ScalarArrayOpExpr execution.
+ */
+#define MIN_ARRAY_SIZE_FOR_HASHED_SEL 9
+
+/*
+ * MCVHashEntry
+ *		Hash table entry used to look up array elements in an MCV list
+ */
+typedef struct MCVHashEntry
+{
+	Datum		value;			/* most common value */
+	int			index;			/* its position in the MCV list */
+	uint32		status;			/* hash status */
+	uint32		hash;			/* hash value (cached) */
+} MCVHashEntry;
+
+/* Hash and equality support functions for an MCV hash table */
+typedef struct MCVHashContext
+{
+	FunctionCallInfo hash_fcinfo;
+	FunctionCallInfo eq_fcinfo;
+} MCVHashContext;
+
+#define SH_PREFIX mcvhash
+#define SH_ELEMENT_TYPE MCVHashEntry
+#define SH_KEY_TYPE Datum
+#define SH_SCOPE static inline
+#define SH_DECLARE
+#include "lib/simplehash.h"
+
+static uint32 mcvhash_value_hash(struct mcvhash_hash *tb, Datum key);
+static bool mcvhash_value_match(struct mcvhash_hash *tb, Datum key1,
+								Datum key2);
+
+#define SH_PREFIX mcvhash
+#define SH_ELEMENT_TYPE MCVHashEntry
+#define SH_KEY_TYPE Datum
+#define SH_KEY value
+#define SH_HASH_KEY(tb, key) mcvhash_value_hash(tb, key)
+#define SH_EQUAL(tb, a, b) mcvhash_value_match(tb, a, b)
+#define SH_SCOPE static inline
+#define SH_STORE_HASH
+#define SH_GET_HASH(tb, a) a->hash
+#define SH_DEFINE
+#include "lib/simplehash.h"
+
 /* Hooks for plugins to get control when we ask for stats */
 get_relation_stats_hook_type get_relation_stats_hook = NULL;
 get_index_stats_hook_type get_index_stats_hook = NULL;
 
 static double eqsel_internal(PG_FUNCTION_ARGS, bool negate);
+static double var_eq_nonmcv_sel(VariableStatData *vardata,
+								AttStatsSlot *sslot, double nullfrac);
+static bool scalararraysel_eq_elements(PlannerInfo *root, Node *leftop,
+									   Oid operator, bool negate,
+									   Oid collation, Const *sample,
+									   Datum *elem_values, bool *elem_nulls,
+									   int num_elems, int varRelid,
+									   Selectivity *elem_sel);
+static mcvhash_hash *build_mcv_hash(AttStatsSlot *sslot, Oid eqfuncoid,
+									Oid hashfuncoid, Oid collation);
 static double eqjoinsel_inner(Oid opfuncoid, Oid collation,
 							  VariableStatData *vardata1, VariableStatData *vardata2,
 							  double nd1, double nd2,
@@ -406,33 +466,9 @@ var_eq_const(VariableStatData *vardata, Oid oproid, Oid collation,
 		{
 			/*
 			 * Comparison is against a constant that is neither NULL nor any
-			 * of the common values.  Its selectivity cannot be more than
-			 * this:
+			 * of the common values.
 			 */
-			double		sumcommon = 0.0;
-			double		otherdistinct;
-
-			for (i = 0; i < sslot.nnumbers; i++)
-				sumcommon += sslot.numbers[i];
-			selec = 1.0 - sumcommon - nullfrac;
-			CLAMP_PROBABILITY(selec);
-
-			/*
-			 * and in fact it's probably a good deal less. We approximate that
-			 * all the not-common values share this remaining fraction
-			 * equally, so we divide by the number of other distinct values.
-			 */
-			otherdistinct = get_variable_numdistinct(vardata, &isdefault) -
-				sslot.nnumbers;
-			if (otherdistinct > 1)
-				selec /= otherdistinct;
-
-			/*
-			 * Another cross-check: selectivity shouldn't be estimated as more
-			 * than the least common "most common value".
-			 */
-			if (sslot.nnumbers > 0 && selec > sslot.numbers[sslot.nnumbers - 1])
-				selec = sslot.numbers[sslot.nnumbers - 1];
+			selec = var_eq_nonmcv_sel(vardata, &sslot, nullfrac);
 		}
 
 		free_attstatsslot(&sslot);
@@ -457,6 +493,50 @@ var_eq_const(VariableStatData *vardata, Oid oproid, Oid collation,
 	return selec;
 }
 
+/*
+ * var_eq_nonmcv_sel --- selectivity of "var = const" for a non-NULL
+ * constant that matches none of the var's most common values
+ *
+ * sslot is the var's MCV slot; it may be empty if there are no MCVs.
+ */
+static double
+var_eq_nonmcv_sel(VariableStatData *vardata, AttStatsSlot *sslot,
+				  double nullfrac)
+{
+	double		selec;
+	double		sumcommon = 0.0;
+	double		otherdistinct;
+	bool		isdefault;
+	int			i;
+
+	/*
+	 * The constant's selectivity cannot be more than this:
+	 */
+	for (i = 0; i < sslot->nnumbers; i++)
+		sumcommon += sslot->numbers[i];
+	selec = 1.0 - sumcommon - nullfrac;
+	CLAMP_PROBABILITY(selec);
+
+	/*
+	 * and in fact it's probably a good deal less. We approximate that all
+	 * the not-common values share this remaining fraction equally, so we
+	 * divide by the number of other distinct values.
+	 */
+	otherdistinct = get_variable_numdistinct(vardata, &isdefault) -
+		sslot->nnumbers;
+	if (otherdistinct > 1)
+		selec /= otherdistinct;
+
+	/*
+	 * Another cross-check: selectivity shouldn't be estimated as more than
+	 * the least common "most common value".
+	 */
+	if (sslot->nnumbers > 0 && selec > sslot->numbers[sslot->nnumbers - 1])
+		selec = sslot->numbers[sslot->nnumbers - 1];
+
+	return selec;
+}
+
 /*
  * var_eq_non_const --- eqsel for var = something-other-than-const case
  *
@@ -1929,6 +2009,7 @@ scalararraysel(PlannerInfo *root,
 		int			num_elems;
 		Datum	   *elem_values;
 		bool	   *elem_nulls;
+		Selectivity *elem_sel = NULL;
 		int			i;
 
 		if (arrayisnull)		/* qual can't succeed if null array */
@@ -1941,6 +2022,36 @@ scalararraysel(PlannerInfo *root,
 						  elmlen, elmbyval, elmalign,
 						  &elem_values, &elem_nulls, &num_elems);
 
+		/*
+		 * With eqsel() or neqsel() and a long array, try to estimate all the
+		 * elements at once.  That fetches the column's statistics just once
+		 * and looks each element up in a hash table of the MCVs, instead of
+		 * calling the estimator (and scanning the MCV list) per element.
+		 */
+		if (!is_join_clause && num_elems >= MIN_ARRAY_SIZE_FOR_HASHED_SEL &&
+			(oprsel == F_EQSEL || oprsel == F_NEQSEL))
+		{
+			Const	   *sample;
+
+			sample = makeConst(nominal_element_type,
+							   -1,
+							   nominal_element_collation,
+							   elmlen,
+							   elem_values[0],
+							   elem_nulls[0],
+							   elmbyval);
+			elem_sel = palloc_array(Selectivity, num_elems);
+			if (!scalararraysel_eq_elements(root, leftop, operator,
+											oprsel == F_NEQSEL,
+											clause->inputcollid, sample,
+											elem_values, elem_nulls,
+											num_elems, varRelid, elem_sel))
+			{
+				pfree(elem_sel);
+				elem_sel = NULL;
+			}
+		}
+
 		/*
 		 * For generic operators, we assume the probability of success is
 		 * independent for each array element.  But for "= ANY" or "<> ALL",
@@ -1962,29 +2073,34 @@ scalararraysel(PlannerInfo *root,
 			List	   *args;
 			Selectivity s2;
 
-			args = list_make2(leftop,
-							  makeConst(nominal_element_type,
-										-1,
-										nominal_element_collation,
-										elmlen,
-										elem_values[i],
-										elem_nulls[i],
-										elmbyval));
-			if (is_join_clause)
-				s2 = DatumGetFloat8(FunctionCall5Coll(&oprselproc,
-													  clause->inputcollid,
-													  PointerGetDatum(root),
-													  ObjectIdGetDatum(operator),
-													  PointerGetDatum(args),
-													  Int16GetDatum(jointype),
-													  PointerGetDatum(sjinfo)));
+			if (elem_sel)
+				s2 = elem_sel[i];
 			else
-				s2 = DatumGetFloat8(FunctionCall4Coll(&oprselproc,
-													  clause->inputcollid,
-													  PointerGetDatum(root),
-													  ObjectIdGetDatum(operator),
-													  PointerGetDatum(args),
-													  Int32GetDatum(varRelid)));
+			{
+				args = list_make2(leftop,
+								  makeConst(nominal_element_type,
+											-1,
+											nominal_element_collation,
+											elmlen,
+											elem_values[i],
+											elem_nulls[i],
+											elmbyval));
+				if (is_join_clause)
+					s2 = DatumGetFloat8(FunctionCall5Coll(&oprselproc,
+														  clause->inputcollid,
+														  PointerGetDatum(root),
+														  ObjectIdGetDatum(operator),
+														  PointerGetDatum(args),
+														  Int16GetDatum(jointype),
+														  PointerGetDatum(sjinfo)));
+				else
+					s2 = DatumGetFloat8(FunctionCall4Coll(&oprselproc,
+														  clause->inputcollid,
+														  PointerGetDatum(root),
+														  ObjectIdGetDatum(operator),
+														  PointerGetDatum(args),
+														  Int32GetDatum(varRelid)));
+			}
 
 			if (useOr)
 			{
@@ -2126,6 +2242,214 @@ scalararraysel(PlannerInfo *root,
 	return s1;
 }
 
+/*
+ * scalararraysel_eq_elements
+ *		Estimate "var = ANY (const array)" or "var <> ALL (const array)"
+ *		element by element, in one pass over the var's statistics.
+ *
+ * This computes the same per-element selectivities that eqsel() or neqsel()
+ * (per "negate") would return, storing them into elem_sel[], but it examines
+ * the variable and fetches its MCV list only once, and matches the elements
+ * against the MCVs through a hash table.  "sample" is a Const built from one
+ * of the array elements; it's used only to identify the variable.
+ *
+ * Returns false, without filling elem_sel[], if the clause doesn't have the
+ * expected form or the operator can't be hashed; the caller must then fall
+ * back to invoking the estimator for each element.
+ */
+static bool
+scalararraysel_eq_elements(PlannerInfo *root, Node *leftop, Oid operator,
+						   bool negate, Oid collation, Const *sample,
+						   Datum *elem_values, bool *elem_nulls,
+						   int num_elems, int varRelid,
+						   Selectivity *elem_sel)
+{
+	VariableStatData vardata;
+	Node	   *other;
+	bool		varonleft;
+	double		nullfrac = 0.0;
+	double		nonmcv_sel;
+	bool		isdefault;
+	AttStatsSlot sslot;
+	mcvhash_hash *mcvtab = NULL;
+	Oid			opfuncoid;
+	int			i;
+
+	/* As in eqsel_internal, estimate <> using the corresponding = operator */
+	if (negate)
+	{
+		operator = get_negator(operator);
+		if (!OidIsValid(operator))
+			return false;
+	}
+
+	if (!get_restriction_variable(root, list_make2(leftop, sample), varRelid,
+								  &vardata, &other, &varonleft))
+		return false;
+	if (!varonleft)
+	{
+		ReleaseVariableStats(vardata);
+		return false;
+	}
+
+	if (HeapTupleIsValid(vardata.statsTuple))
+	{
+		Form_pg_statistic stats;
+
+		stats = (Form_pg_statistic) GETSTRUCT(vardata.statsTuple);
+		nullfrac = stats->stanullfrac;
+	}
+
+	/*
+	 * Work out the selectivity of an element that matches no MCV, and collect
+	 * the MCVs if there are any, following the same rules as var_eq_const.
+	 */
+	memset(&sslot, 0, sizeof(sslot));
+	if (vardata.isunique && vardata.rel && vardata.rel->tuples >= 1.0)
+	{
+		nonmcv_sel = 1.0 / vardata.rel->tuples;
+	}
+	else if (HeapTupleIsValid(vardata.statsTuple) &&
+			 statistic_proc_security_check(&vardata,
+										   (opfuncoid = get_opcode(operator))))
+	{
+		if (get_attstatsslot(&sslot, vardata.statsTuple,
+							 STATISTIC_KIND_MCV, InvalidOid,
+							 ATTSTATSSLOT_VALUES | ATTSTATSSLOT_NUMBERS) &&
+			sslot.nvalues > 0)
+		{
+			RegProcedure lhs_hashfn;
+			RegProcedure rhs_hashfn;
+
+			/*
+			 * We need a hash function that is consistent with the operator
+			 * and applies to both the MCVs and the array elements.
+			 */
+			if (!get_op_hash_functions(operator, &lhs_hashfn, &rhs_hashfn) ||
+				lhs_hashfn != rhs_hashfn ||
+				!statistic_proc_security_check(&vardata, lhs_hashfn))
+			{
+				free_attstatsslot(&sslot);
+				ReleaseVariableStats(vardata);
+				return false;
+			}
+
+			mcvtab = build_mcv_hash(&sslot, opfuncoid, lhs_hashfn, collation);
+		}
+		nonmcv_sel = var_eq_nonmcv_sel(&vardata, &sslot, nullfrac);
+	}
+	else
+	{
+		/* No ANALYZE stats available; see var_eq_const */
+		nonmcv_sel = 1.0 / get_variable_numdistinct(&vardata, &isdefault);
+	}
+
+	for (i = 0; i < num_elems; i++)
+	{
+		double		selec;
+
+		/* assume the operator is strict, as var_eq_const does */
+		if (elem_nulls[i])
+		{
+			elem_sel[i] = 0.0;
+			continue;
+		}
+
+		selec = nonmcv_sel;
+		if (mcvtab)
+		{
+			MCVHashEntry *entry = mcvhash_lookup(mcvtab, elem_values[i]);
+
+			if (entry)
+				selec = sslot.numbers[entry->index];
+		}
+
+		if (negate)
+			selec = 1.0 - selec - nullfrac;
+		CLAMP_PROBABILITY(selec);
+		elem_sel[i] = selec;
+	}
+
+	if (mcvtab)
+		mcvhash_destroy(mcvtab);
+	free_attstatsslot(&sslot);
+	ReleaseVariableStats(vardata);
+
+	return true;
+}
+
+/*
+ * Build a hash table over the values in an MCV statistics slot, using the
+ * given equality and hash functions.  Each entry remembers the position of
+ * the first MCV equal to it, so lookups match what a linear search would.
+ */
+static mcvhash_hash *
+build_mcv_hash(AttStatsSlot *sslot, Oid eqfuncoid, Oid hashfuncoid,
+			   Oid collation)
+{
+	MCVHashContext *ctx = palloc(sizeof(MCVHashContext));
+	FmgrInfo   *eqproc = palloc(sizeof(FmgrInfo));
+	FmgrInfo   *hashproc = palloc(sizeof(FmgrInfo));
+	mcvhash_hash *mcvtab;
+	int			i;
+
+	fmgr_info(eqfuncoid, eqproc);
+	fmgr_info(hashfuncoid, hashproc);
+	ctx->eq_fcinfo = palloc(SizeForFunctionCallInfo(2));
+	InitFunctionCallInfoData(*ctx->eq_fcinfo, eqproc, 2, collation,
+							 NULL, NULL);
+	ctx->hash_fcinfo = palloc(SizeForFunctionCallInfo(1));
+	InitFunctionCallInfoData(*ctx->hash_fcinfo, hashproc, 1, collation,
+							 NULL, NULL);
+
+	mcvtab = mcvhash_create(CurrentMemoryContext, sslot->nvalues, ctx);
+	for (i = 0; i < sslot->nvalues; i++)
+	{
+		MCVHashEntry *entry;
+		bool		found;
+
+		entry = mcvhash_insert(mcvtab, sslot->values[i], &found);
+		if (!found)
+			entry->index = i;
+	}
+
+	return mcvtab;
+}
+
+/*
+ * Hash and equality callbacks for MCV hash tables.  Like var_eq_const, we
+ * treat a NULL result from the equality function as "not equal".
+ */
+static uint32
+mcvhash_value_hash(struct mcvhash_hash *tb, Datum key)
+{
+	MCVHashContext *ctx = (MCVHashContext *) tb->private_data;
+	FunctionCallInfo fcinfo = ctx->hash_fcinfo;
+
+	fcinfo->args[0].value = key;
+	fcinfo->args[0].isnull = false;
+	fcinfo->isnull = false;
+
+	return DatumGetUInt32(FunctionCallInvoke(fcinfo));
+}
+
+static bool
+mcvhash_value_match(struct mcvhash_hash *tb, Datum key1, Datum key2)
+{
+	MCVHashContext *ctx = (MCVHashContext *) tb->private_data;
+	FunctionCallInfo fcinfo = ctx->eq_fcinfo;
+	Datum		result;
+
+	fcinfo->args[0].value = key1;
+	fcinfo->args[0].isnull = false;
+	fcinfo->args[1].value = key2;
+	fcinfo->args[1].isnull = false;
+	fcinfo->isnull = false;
+	result = FunctionCallInvoke(fcinfo);
+
+	return !fcinfo->isnull && DatumGetBool(result);
+}
+
 /*
  * Estimate number of elements in the array yielded by an expression.
  *
@@ -54,6 +54,7 @@
 #include "storage/sinvaladt.h"
 #include "storage/smgr.h"
 #include "storage/sync.h"
+#include "tcop/backend_startup.h"
 #include "tcop/tcopprot.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
@@ -66,6 +67,7 @@
 #include "utils/snapmgr.h"
 #include "utils/syscache.h"
 #include "utils/timeout.h"
+#include "utils/timestamp.h"
 
 static HeapTuple GetDatabaseTuple(const char *dbname);
 static HeapTuple GetDatabaseTupleByOid(Oid dboid);
@@ -244,7 +246,9 @@ PerformAuthentication(Port *port)
 	 * Now perform authentication exchange.
 	 */
 	set_ps_display("authentication");
+	conn_timing.auth_start = GetCurrentTimestamp();
 	ClientAuthentication(port); /* might not return, if failure */
+	conn_timing.auth_end = GetCurrentTimestamp();
 
 	/*
 	 * Done with authentication.  Disable the timeout, and log if needed.
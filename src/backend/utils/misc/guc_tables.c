@@ -44,6 +44,7 @@
 #include "commands/trigger.h"
 #include "commands/user.h"
 #include "commands/vacuum.h"
+#include "common/compression.h"
 #include "common/file_utils.h"
 #include "common/scram-common.h"
 #include "jit/jit.h"
@@ -474,6 +475,21 @@ static const struct config_enum_entry wal_compression_options[] = {
 	{NULL, 0, false}
 };
 
+static const struct config_enum_entry wal_receiver_compression_options[] = {
+	{"off", PG_COMPRESSION_NONE, false},
+#ifdef USE_LZ4
+	{"lz4", PG_COMPRESSION_LZ4, false},
+#endif
+#ifdef USE_ZSTD
+	{"zstd", PG_COMPRESSION_ZSTD, false},
+#endif
+	{"none", PG_COMPRESSION_NONE, true},
+	{"false", PG_COMPRESSION_NONE, true},
+	{"no", PG_COMPRESSION_NONE, true},
+	{"0", PG_COMPRESSION_NONE, true},
+	{NULL, 0, false}
+};
+
 /*
  * Options for enum values stored in other modules
  */
@@ -2772,6 +2788,16 @@ struct config_int ConfigureNamesInt[] =
 		1600000000, 0, 2100000000,
 		NULL, NULL, NULL
 	},
+	{
+		{"vacuum_eager_freeze_pages", PGC_USERSET, CLIENT_CONN_STATEMENT,
+			gettext_noop("Maximum number of all-visible pages a non-aggressive VACUUM scans to freeze them eagerly."),
+			gettext_noop("0 disables eager freezing."),
+			GUC_UNIT_BLOCKS
+		},
+		&vacuum_eager_freeze_pages,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
 
 	/*
 	 * See also CheckRequiredParameterValues() if this parameter changes
@@ -5033,6 +5059,16 @@ struct config_enum ConfigureNamesEnum[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"wal_receiver_compression", PGC_SIGHUP, REPLICATION_STANDBY,
+			gettext_noop("Compresses the WAL stream received from the sending server with specified method."),
+			gettext_noop("Takes effect when the WAL receiver next starts streaming.")
+		},
+		&wal_receiver_compression,
+		PG_COMPRESSION_NONE, wal_receiver_compression_options,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"wal_level", PGC_POSTMASTER, WAL_SETTINGS,
 			gettext_noop("Sets the level of information written to the WAL."),
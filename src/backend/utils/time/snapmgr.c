@@ -512,6 +512,8 @@ SetTransactionSnapshot(Snapshot sourcesnap, VirtualTransactionId *sourcevxid,
 			   sourcesnap->subxcnt * sizeof(TransactionId));
 	CurrentSnapshot->suboverflowed = sourcesnap->suboverflowed;
 	CurrentSnapshot->takenDuringRecovery = sourcesnap->takenDuringRecovery;
+	CurrentSnapshot->xids_sorted = false;
+	CurrentSnapshot->xid_searches = 0;
 	/* NB: curcid should NOT be copied, it's a local matter */
 
 	CurrentSnapshot->snapXactCompletionCount = 0;
@@ -1800,6 +1802,8 @@ RestoreSnapshot(char *start_address)
 	snapshot->subxcnt = serialized_snapshot.subxcnt;
 	snapshot->suboverflowed = serialized_snapshot.suboverflowed;
 	snapshot->takenDuringRecovery = serialized_snapshot.takenDuringRecovery;
+	snapshot->xids_sorted = false;
+	snapshot->xid_searches = 0;
 	snapshot->curcid = serialized_snapshot.curcid;
 	snapshot->whenTaken = serialized_snapshot.whenTaken;
 	snapshot->lsn = serialized_snapshot.lsn;
@@ -1842,6 +1846,45 @@ RestoreTransactionSnapshot(Snapshot snapshot, void *source_pgproc)
 	SetTransactionSnapshot(snapshot, NULL, InvalidPid, source_pgproc);
 }
 
+/*
+ * Searching a snapshot's XID arrays is linear, which gets expensive with
+ * thousands of concurrent transactions when a snapshot is used to check the
+ * visibility of many tuples.  Once arrays holding at least
+ * XID_SORT_MIN_XIDS entries have been searched XID_SORT_MIN_SEARCHES times,
+ * XidInMVCCSnapshot sorts them in place and switches to binary search.  Short
+ * transactions, which only do a few checks per snapshot, never pay for the
+ * sort.
+ */
+#define XID_SORT_MIN_XIDS		128
+#define XID_SORT_MIN_SEARCHES	16
+
+/*
+ * Search one of the XID arrays of a snapshot.  The arrays are sorted in raw
+ * numeric order, like xidComparator would.
+ */
+static inline bool
+XidInSnapshotArray(TransactionId xid, const TransactionId *xids, uint32 nxids,
+				   bool sorted)
+{
+	uint32		lo = 0;
+	uint32		hi = nxids;
+
+	if (!sorted)
+		return pg_lfind32(xid, xids, nxids);
+
+	while (lo < hi)
+	{
+		uint32		mid = lo + (hi - lo) / 2;
+
+		if (xids[mid] < xid)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo < nxids && xids[lo] == xid;
+}
+
 /*
  * XidInMVCCSnapshot
  *		Is the given XID still-in-progress according to the snapshot?
@@ -1870,6 +1913,19 @@ XidInMVCCSnapshot(TransactionId xid, Snapshot snapshot)
 	if (TransactionIdFollowsOrEquals(xid, snapshot->xmax))
 		return true;
 
+	/* Switch to binary search if the arrays are large and much used */
+	if (!snapshot->xids_sorted &&
+		snapshot->xcnt + (uint32) snapshot->subxcnt >= XID_SORT_MIN_XIDS &&
+		++snapshot->xid_searches >= XID_SORT_MIN_SEARCHES)
+	{
+		qsort(snapshot->xip, snapshot->xcnt, sizeof(TransactionId),
+			  xidComparator);
+		if (snapshot->subxcnt > 0)
+			qsort(snapshot->subxip, snapshot->subxcnt, sizeof(TransactionId),
+				  xidComparator);
+		snapshot->xids_sorted = true;
+	}
+
 	/*
 	 * Snapshot information is stored slightly differently in snapshots taken
 	 * during recovery.
@@ -1886,7 +1942,8 @@ XidInMVCCSnapshot(TransactionId xid, Snapshot snapshot)
 		if (!snapshot->suboverflowed)
 		{
 			/* we have full data, so search subxip */
-			if (pg_lfind32(xid, snapshot->subxip, snapshot->subxcnt))
+			if (XidInSnapshotArray(xid, snapshot->subxip, snapshot->subxcnt,
+								   snapshot->xids_sorted))
 				return true;
 
 			/* not there, fall through to search xip[] */
@@ -1908,7 +1965,8 @@ XidInMVCCSnapshot(TransactionId xid, Snapshot snapshot)
 				return false;
 		}
 
-		if (pg_lfind32(xid, snapshot->xip, snapshot->xcnt))
+		if (XidInSnapshotArray(xid, snapshot->xip, snapshot->xcnt,
+							   snapshot->xids_sorted))
 			return true;
 	}
 	else
@@ -1942,7 +2000,8 @@ XidInMVCCSnapshot(TransactionId xid, Snapshot snapshot)
 		 * indeterminate xid. We don't know whether it's top level or subxact
 		 * but it doesn't matter. If it's present, the xid is visible.
 		 */
-		if (pg_lfind32(xid, snapshot->subxip, snapshot->subxcnt))
+		if (XidInSnapshotArray(xid, snapshot->subxip, snapshot->subxcnt,
+							   snapshot->xids_sorted))
 			return true;
 	}
 
@@ -13,6 +13,7 @@
 
 #include "access/xlogdefs.h"
 #include "datatype/timestamp.h"
+#include "port/pg_bitutils.h"
 #include "portability/instr_time.h"
 #include "postmaster/pgarch.h"	/* for MAX_XFN_CHARS */
 #include "replication/conflict.h"
@@ -167,6 +168,8 @@ typedef struct PgStat_BackendSubEntry
 	PgStat_Counter apply_error_count;
 	PgStat_Counter sync_error_count;
 	PgStat_Counter conflict_count[CONFLICT_NUM_TYPES];
+	PgStat_Counter apply_xact_count;
+	PgStat_Counter parallel_apply_xact_count;
 } PgStat_BackendSubEntry;
 
 /* ----------
@@ -267,7 +270,32 @@ typedef struct PgStat_TableXactStatus
  * ------------------------------------------------------------
  */
 
-#define PGSTAT_FILE_FORMAT_ID	0x01A5BCAF
+#define PGSTAT_FILE_FORMAT_ID	0x01A5BCB1
+
+/*
+ * Latency histograms.  Timed operations (IO, WAL writes and syncs) are also
+ * counted in log2-scaled buckets, so that tail latencies remain visible and
+ * are not averaged away in the accumulated times.  Bucket 0 counts operations
+ * that took less than PGSTAT_LATENCY_HIST_MIN_US microseconds, bucket i
+ * those that took at least MIN_US << (i - 1) and less than MIN_US << i, and
+ * the last bucket everything slower than that.
+ */
+#define PGSTAT_LATENCY_HIST_BUCKETS	16
+#define PGSTAT_LATENCY_HIST_MIN_US	8
+
+typedef PgStat_Counter PgStat_LatencyHist[PGSTAT_LATENCY_HIST_BUCKETS];
+
+static inline int
+pgstat_latency_hist_bucket(instr_time duration)
+{
+	uint64		us = INSTR_TIME_GET_MICROSEC(duration);
+	int			bucket;
+
+	if (us < PGSTAT_LATENCY_HIST_MIN_US)
+		return 0;
+	bucket = pg_leftmost_one_pos64(us / PGSTAT_LATENCY_HIST_MIN_US) + 1;
+	return Min(bucket, PGSTAT_LATENCY_HIST_BUCKETS - 1);
+}
 
 typedef struct PgStat_ArchiverStats
 {
@@ -345,6 +373,8 @@ typedef struct PgStat_BktypeIO
 {
 	PgStat_Counter counts[IOOBJECT_NUM_TYPES][IOCONTEXT_NUM_TYPES][IOOP_NUM_TYPES];
 	PgStat_Counter times[IOOBJECT_NUM_TYPES][IOCONTEXT_NUM_TYPES][IOOP_NUM_TYPES];
+	/* latency of each timed call, only collected with track_io_timing */
+	PgStat_LatencyHist hists[IOOBJECT_NUM_TYPES][IOCONTEXT_NUM_TYPES][IOOP_NUM_TYPES];
 } PgStat_BktypeIO;
 
 typedef struct PgStat_IO
@@ -430,6 +460,8 @@ typedef struct PgStat_StatSubEntry
 	PgStat_Counter apply_error_count;
 	PgStat_Counter sync_error_count;
 	PgStat_Counter conflict_count[CONFLICT_NUM_TYPES];
+	PgStat_Counter apply_xact_count;
+	PgStat_Counter parallel_apply_xact_count;
 	TimestampTz stat_reset_timestamp;
 } PgStat_StatSubEntry;
 
@@ -475,6 +507,8 @@ typedef struct PgStat_WalStats
 	PgStat_Counter wal_sync;
 	PgStat_Counter wal_write_time;
 	PgStat_Counter wal_sync_time;
+	PgStat_LatencyHist wal_write_hist;	/* only with track_wal_io_timing */
+	PgStat_LatencyHist wal_sync_hist;
 	TimestampTz stat_reset_timestamp;
 } PgStat_WalStats;
 
@@ -491,6 +525,8 @@ typedef struct PgStat_PendingWalStats
 	PgStat_Counter wal_sync;
 	instr_time	wal_write_time;
 	instr_time	wal_sync_time;
+	PgStat_LatencyHist wal_write_hist;
+	PgStat_LatencyHist wal_sync_hist;
 } PgStat_PendingWalStats;
 
 
@@ -566,6 +602,7 @@ extern void pgstat_count_io_op_time(IOObject io_object, IOContext io_context,
 extern PgStat_IO *pgstat_fetch_stat_io(void);
 extern const char *pgstat_get_io_context_name(IOContext io_context);
 extern const char *pgstat_get_io_object_name(IOObject io_object);
+extern const char *pgstat_get_io_op_name(IOOp io_op);
 
 extern bool pgstat_tracks_io_bktype(BackendType bktype);
 extern bool pgstat_tracks_io_object(BackendType bktype,
@@ -696,6 +733,11 @@ extern void pgstat_twophase_postabort(TransactionId xid, uint16 info,
 extern PgStat_StatTabEntry *pgstat_fetch_stat_tabentry(Oid relid);
 extern PgStat_StatTabEntry *pgstat_fetch_stat_tabentry_ext(bool shared,
 														   Oid reloid);
+typedef void (*pgstat_tabentry_callback) (Oid reloid, bool shared,
+										  const PgStat_StatTabEntry *tabentry,
+										  void *arg);
+extern void pgstat_scan_stat_tabentries(pgstat_tabentry_callback callback,
+										void *arg);
 extern PgStat_TableStatus *find_tabstat_entry(Oid rel_id);
 
 
@@ -735,6 +777,7 @@ extern PgStat_SLRUStats *pgstat_fetch_slru(void);
 
 extern void pgstat_report_subscription_error(Oid subid, bool is_apply_error);
 extern void pgstat_report_subscription_conflict(Oid subid, ConflictType type);
+extern void pgstat_report_subscription_xact(Oid subid, bool parallel);
 extern void pgstat_create_subscription(Oid subid);
 extern void pgstat_drop_subscription(Oid subid);
 extern PgStat_StatSubEntry *pgstat_fetch_stat_subscription(Oid subid);
@@ -13,6 +13,7 @@
 #define _WALSENDER_PRIVATE_H
 
 #include "access/xlog.h"
+#include "common/compression.h"
 #include "lib/ilist.h"
 #include "nodes/nodes.h"
 #include "nodes/replnodes.h"
@@ -76,6 +77,16 @@ typedef struct WalSnd
 	TimestampTz replyTime;
 
 	ReplicationKind kind;
+
+	/*
+	 * Compression of the WAL stream sent to the standby, and the amount of
+	 * WAL data compressed, the resulting compressed size, and the time spent
+	 * compressing it (in microseconds), since this walsender started.
+	 */
+	pg_compress_algorithm compression;
+	uint64		compressInBytes;
+	uint64		compressOutBytes;
+	int64		compressTime;
 } WalSnd;
 
 extern PGDLLIMPORT WalSnd *MyWalSnd;
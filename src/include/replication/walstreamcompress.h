@@ -0,0 +1,33 @@
+/*-------------------------------------------------------------------------
+ *
+ * walstreamcompress.h
+ *	  Compression of the WAL data sent over physical replication connections.
+ *
+ * Portions Copyright (c) 2010-2024, PostgreSQL Global Development Group
+ *
+ * src/include/replication/walstreamcompress.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef _WALSTREAMCOMPRESS_H
+#define _WALSTREAMCOMPRESS_H
+
+#include "common/compression.h"
+#include "lib/stringinfo.h"
+
+typedef struct WalStreamCompressor WalStreamCompressor;
+typedef struct WalStreamDecompressor WalStreamDecompressor;
+
+extern bool WalStreamCompressionSupported(pg_compress_algorithm algorithm);
+
+extern WalStreamCompressor *WalStreamCompressorCreate(pg_compress_specification *spec);
+extern void WalStreamCompress(WalStreamCompressor *cs, const char *data,
+							  size_t len, StringInfo out);
+extern void WalStreamCompressorFree(WalStreamCompressor *cs);
+
+extern WalStreamDecompressor *WalStreamDecompressorCreate(pg_compress_algorithm algorithm);
+extern void WalStreamDecompress(WalStreamDecompressor *ds, const char *data,
+								size_t len, StringInfo out);
+extern void WalStreamDecompressorFree(WalStreamDecompressor *ds);
+
+#endif							/* _WALSTREAMCOMPRESS_H */
@@ -14,6 +14,8 @@
 #ifndef BACKEND_STARTUP_H
 #define BACKEND_STARTUP_H
 
+#include "datatype/timestamp.h"
+
 /* GUCs */
 extern PGDLLIMPORT bool Trace_connection_negotiation;
 
@@ -37,8 +39,25 @@ typedef enum CAC_state
 typedef struct BackendStartupData
 {
 	CAC_state	canAcceptConnections;
+
+	/* time at which postmaster started launching the backend */
+	TimestampTz fork_started;
 } BackendStartupData;
 
+/*
+ * Times at which the stages of connection setup began and ended, for
+ * log_connections.
+ */
+typedef struct ConnectionTiming
+{
+	TimestampTz fork_start;
+	TimestampTz fork_end;
+	TimestampTz auth_start;
+	TimestampTz auth_end;
+} ConnectionTiming;
+
+extern PGDLLIMPORT ConnectionTiming conn_timing;
+
 extern void BackendMain(char *startup_data, size_t startup_data_len) pg_attribute_noreturn();
 
 #endif							/* BACKEND_STARTUP_H */
@@ -279,6 +279,25 @@ typedef struct LocalPgBackendStatus
 } LocalPgBackendStatus;
 
 
+/* ----------
+ * PgBackendSample
+ *
+ * The part of a backend's status that describes what it's doing at a given
+ * moment, as returned by pgstat_get_backend_sample().
+ * ----------
+ */
+typedef struct PgBackendSample
+{
+	int			pid;
+	BackendType backendType;
+	Oid			databaseid;
+	Oid			userid;
+	BackendState state;
+	uint64		query_id;
+	uint32		wait_event_info;
+} PgBackendSample;
+
+
 /* ----------
  * GUC parameters
  * ----------
@@ -334,6 +353,8 @@ extern int	pgstat_fetch_stat_numbackends(void);
 extern PgBackendStatus *pgstat_get_beentry_by_proc_number(ProcNumber procNumber);
 extern LocalPgBackendStatus *pgstat_get_local_beentry_by_proc_number(ProcNumber procNumber);
 extern LocalPgBackendStatus *pgstat_get_local_beentry_by_index(int idx);
+extern bool pgstat_get_backend_sample(ProcNumber procNumber,
+									  PgBackendSample *sample);
 extern char *pgstat_clip_activity(const char *raw_activity);
 
 
@@ -678,6 +678,11 @@ extern void pgstat_reset_entries_of_kind(PgStat_Kind kind, TimestampTz ts);
 extern void pgstat_reset_matching_entries(bool (*do_reset) (PgStatShared_HashEntry *, Datum),
 										  Datum match_data,
 										  TimestampTz ts);
+extern void pgstat_scan_entries_of_kind(PgStat_Kind kind,
+										void (*callback) (const PgStat_HashKey *key,
+														  const void *stats,
+														  void *arg),
+										void *arg);
 
 extern void pgstat_request_entry_refs_gc(void);
 extern PgStatShared_Common *pgstat_init_entry(PgStat_Kind kind,
@@ -184,6 +184,14 @@ typedef struct SnapshotData
 	bool		takenDuringRecovery;	/* recovery-shaped snapshot? */
 	bool		copied;			/* false if it's a static snapshot */
 
+	/*
+	 * XidInMVCCSnapshot() sorts large xip[] and subxip[] arrays in place once
+	 * they have been searched often enough, to then use binary search.
+	 * Whoever fills in the arrays must reset both of these.
+	 */
+	bool		xids_sorted;	/* xip[] and subxip[] in ascending order? */
+	uint32		xid_searches;	/* # of linear searches of the arrays */
+
 	CommandId	curcid;			/* in my xact, CID < curcid are visible */
 
 	/*
@@ -107,10 +107,12 @@ static int	pqPipelineFlush(PGconn *conn);
  * we need to be able to enlarge it via realloc, and our trivial space
  * allocator doesn't handle that effectively.  (Too bad the FE/BE protocol
  * doesn't tell us up front how many tuples will be returned.)
- * All other subsidiary storage for a PGresult is kept in PGresult_data blocks
- * of size PGRESULT_DATA_BLOCKSIZE.  The overhead at the start of each block
- * is just a link to the next one, if any.  Free-space management info is
- * kept in the owning PGresult.
+ * All other subsidiary storage for a PGresult is kept in PGresult_data blocks.
+ * The first one is of size PGRESULT_DATA_BLOCKSIZE, and each following one
+ * is twice the size of the previous one, up to PGRESULT_MAX_DATA_BLOCKSIZE,
+ * so that a large result doesn't take a malloc call for every couple of rows.
+ * The overhead at the start of each block is just a link to the next one, if
+ * any.  Free-space management info is kept in the owning PGresult.
  * A query returning a small amount of data will thus require three malloc
  * calls: one for the PGresult, one for the tuples pointer array, and one
  * PGresult_data block.
@@ -122,7 +124,8 @@ static int	pqPipelineFlush(PGconn *conn);
  * around very long anyway, so some wasted space within one is not a problem.
  *
  * Tuning constants for the space allocator are:
- * PGRESULT_DATA_BLOCKSIZE: size of a standard allocation block, in bytes
+ * PGRESULT_DATA_BLOCKSIZE: size of the first allocation block, in bytes
+ * PGRESULT_MAX_DATA_BLOCKSIZE: maximum size of an allocation block, in bytes
  * PGRESULT_ALIGN_BOUNDARY: assumed alignment requirement for binary data
  * PGRESULT_SEP_ALLOC_THRESHOLD: objects bigger than this are given separate
  *	 blocks, instead of being crammed into a regular allocation block.
@@ -140,6 +143,7 @@ static int	pqPipelineFlush(PGconn *conn);
  */
 
 #define PGRESULT_DATA_BLOCKSIZE		2048
+#define PGRESULT_MAX_DATA_BLOCKSIZE	(64 * 1024)
 #define PGRESULT_ALIGN_BOUNDARY		MAXIMUM_ALIGNOF /* from configure */
 #define PGRESULT_BLOCK_OVERHEAD		Max(sizeof(PGresult_data), PGRESULT_ALIGN_BOUNDARY)
 #define PGRESULT_SEP_ALLOC_THRESHOLD	(PGRESULT_DATA_BLOCKSIZE / 2)
@@ -183,6 +187,7 @@ PQmakeEmptyPGresult(PGconn *conn, ExecStatusType status)
 	result->curBlock = NULL;
 	result->curOffset = 0;
 	result->spaceLeft = 0;
+	result->nextBlockSize = PGRESULT_DATA_BLOCKSIZE;
 	result->memorySize = sizeof(PGresult);
 
 	if (conn)
@@ -564,6 +569,7 @@ pqResultAlloc(PGresult *res, size_t nBytes, bool isBinary)
 {
 	char	   *space;
 	PGresult_data *block;
+	int			block_size;
 
 	if (!res)
 		return NULL;
@@ -630,25 +636,30 @@ pqResultAlloc(PGresult *res, size_t nBytes, bool isBinary)
 	}
 
 	/* Otherwise, start a new block. */
-	block = (PGresult_data *) malloc(PGRESULT_DATA_BLOCKSIZE);
+	block_size = res->nextBlockSize;
+	block = (PGresult_data *) malloc(block_size);
 	if (!block)
 		return NULL;
-	res->memorySize += PGRESULT_DATA_BLOCKSIZE;
+	res->memorySize += block_size;
 	block->next = res->curBlock;
 	res->curBlock = block;
 	if (isBinary)
 	{
 		/* object needs full alignment */
 		res->curOffset = PGRESULT_BLOCK_OVERHEAD;
-		res->spaceLeft = PGRESULT_DATA_BLOCKSIZE - PGRESULT_BLOCK_OVERHEAD;
+		res->spaceLeft = block_size - PGRESULT_BLOCK_OVERHEAD;
 	}
 	else
 	{
 		/* we can cram it right after the overhead pointer */
 		res->curOffset = sizeof(PGresult_data);
-		res->spaceLeft = PGRESULT_DATA_BLOCKSIZE - sizeof(PGresult_data);
+		res->spaceLeft = block_size - sizeof(PGresult_data);
 	}
 
+	/* Make the next block bigger, in case the result keeps growing */
+	if (res->nextBlockSize < PGRESULT_MAX_DATA_BLOCKSIZE)
+		res->nextBlockSize *= 2;
+
 	space = block->space + res->curOffset;
 	res->curOffset += nBytes;
 	res->spaceLeft -= nBytes;
@@ -211,6 +211,7 @@ struct pg_result
 	PGresult_data *curBlock;	/* most recently allocated block */
 	int			curOffset;		/* start offset of free space in block */
 	int			spaceLeft;		/* number of free bytes remaining in block */
+	int			nextBlockSize;	/* size of next standard block to allocate */
 
 	size_t		memorySize;		/* total space allocated for this PGresult */
 };
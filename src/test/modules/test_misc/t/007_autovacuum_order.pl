@@ -0,0 +1,98 @@
+# Copyright (c) 2024, PostgreSQL Global Development Group
+
+# Test the order in which an autovacuum worker processes the tables of a
+# database.
+#
+# Tables should be processed in decreasing order of urgency, i.e. of how far
+# they are past their thresholds, rather than in pg_class order.  Toast
+# tables are never analyzed, so their count of modified tuples must not make
+# them look more urgent than they are.
+
+use strict;
+use warnings FATAL => 'all';
+use PostgreSQL::Test::Cluster;
+use PostgreSQL::Test::Utils;
+use Test::More;
+
+my $node = PostgreSQL::Test::Cluster->new('node');
+$node->init;
+
+# A single worker processes all the tables of the database in one pass.
+$node->append_conf(
+	'postgresql.conf', qq(
+autovacuum = off
+autovacuum_naptime = 1
+autovacuum_max_workers = 1
+log_autovacuum_min_duration = 0
+));
+$node->start;
+
+# Create the tables in the opposite order of their urgency, so that pg_class
+# order would be wrong.  With a vacuum threshold of 50 dead tuples, the
+# scores will be:
+#  - t_high: 300 dead tuples, score 6
+#  - t_low: 100 dead tuples, score 2
+#  - t_toast: 60 dead tuples, score 1.2
+#  - the toast table of t_toast: 120 dead chunks with a threshold of 100,
+#    score 1.2, but more than 2000 tuples modified since it was created
+$node->safe_psql(
+	'postgres', qq(
+CREATE TABLE t_toast (a int, b text)
+  WITH (autovacuum_vacuum_threshold = 50,
+        autovacuum_vacuum_scale_factor = 0,
+        toast.autovacuum_vacuum_threshold = 100,
+        toast.autovacuum_vacuum_scale_factor = 0);
+ALTER TABLE t_toast ALTER COLUMN b SET STORAGE EXTERNAL;
+CREATE TABLE t_low (a int)
+  WITH (autovacuum_vacuum_threshold = 50,
+        autovacuum_vacuum_scale_factor = 0);
+CREATE TABLE t_high (a int)
+  WITH (autovacuum_vacuum_threshold = 50,
+        autovacuum_vacuum_scale_factor = 0);
+INSERT INTO t_toast
+  SELECT i, (SELECT string_agg(md5(i::text || j::text), '')
+             FROM generate_series(1, 100) j)
+  FROM generate_series(1, 1000) i;
+INSERT INTO t_low SELECT generate_series(1, 1000);
+INSERT INTO t_high SELECT generate_series(1, 1000);
+VACUUM ANALYZE t_toast, t_low, t_high;
+DELETE FROM t_toast WHERE a <= 60;
+DELETE FROM t_low WHERE a <= 100;
+DELETE FROM t_high WHERE a <= 300;
+SELECT pg_stat_force_next_flush();
+));
+
+my $toast_name = $node->safe_psql('postgres',
+	"SELECT reltoastrelid::regclass FROM pg_class WHERE relname = 't_toast'"
+);
+
+my $offset = -s $node->logfile;
+
+$node->safe_psql('postgres', 'ALTER SYSTEM SET autovacuum = on');
+$node->reload;
+
+$node->poll_query_until(
+	'postgres', qq(
+SELECT count(*) = 4 FROM pg_stat_all_tables
+WHERE autovacuum_count > 0 AND
+  relid IN ('t_toast'::regclass, 't_low'::regclass, 't_high'::regclass,
+            '$toast_name'::regclass)
+))
+  or die "timed out waiting for autovacuum to process the tables";
+
+# Find the position of each table in the log of the autovacuum run.
+my $log = slurp_file($node->logfile, $offset);
+my %pos;
+foreach my $table ('public.t_high', 'public.t_low', $toast_name)
+{
+	$log =~ /automatic vacuum of table "postgres\.\Q$table\E"/
+	  or die "no autovacuum of $table found in the log";
+	$pos{$table} = $-[0];
+}
+
+cmp_ok($pos{'public.t_high'}, '<', $pos{'public.t_low'},
+	'table further past its threshold is vacuumed first');
+cmp_ok($pos{'public.t_low'}, '<', $pos{$toast_name},
+	'tuples modified in a toast table do not raise its urgency');
+
+done_testing();
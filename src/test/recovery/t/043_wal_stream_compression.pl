@@ -0,0 +1,67 @@
+
+# Copyright (c) 2024, PostgreSQL Global Development Group
+
+# Test streaming replication with a compressed WAL stream.
+use strict;
+use warnings FATAL => 'all';
+use PostgreSQL::Test::Cluster;
+use PostgreSQL::Test::Utils;
+use Test::More;
+
+my @methods;
+push @methods, 'lz4' if check_pg_config("#define USE_LZ4 1");
+push @methods, 'zstd' if check_pg_config("#define USE_ZSTD 1");
+
+if (!@methods)
+{
+	plan skip_all => 'no compression method supported by this build';
+}
+
+my $node_primary = PostgreSQL::Test::Cluster->new('primary');
+$node_primary->init(allows_streaming => 1);
+$node_primary->start;
+
+my $backup_name = 'my_backup';
+$node_primary->backup($backup_name);
+
+$node_primary->safe_psql('postgres', "CREATE TABLE tab_int (a int)");
+
+foreach my $method (@methods)
+{
+	my $node_standby = PostgreSQL::Test::Cluster->new("standby_$method");
+	$node_standby->init_from_backup($node_primary, $backup_name,
+		has_streaming => 1);
+	$node_standby->append_conf('postgresql.conf',
+		"wal_receiver_compression = $method");
+	$node_standby->start;
+
+	$node_primary->safe_psql('postgres',
+		"INSERT INTO tab_int SELECT generate_series(1, 10000)");
+	$node_primary->wait_for_replay_catchup($node_standby);
+
+	my $result = $node_primary->safe_psql('postgres',
+		"SELECT compression, compression_input_bytes > compression_output_bytes
+		 FROM pg_stat_replication WHERE application_name = 'standby_$method'"
+	);
+	is($result, "$method|t", "WAL stream is compressed with $method");
+
+	$result = $node_primary->safe_psql('postgres',
+		"SELECT count(*) FROM tab_int");
+	is( $node_standby->safe_psql('postgres', "SELECT count(*) FROM tab_int"),
+		$result,
+		"streamed content on standby using $method");
+
+	$node_standby->stop;
+}
+
+# An unknown method is rejected by the server
+my ($ret, $stdout, $stderr) = $node_primary->psql(
+	'postgres',
+	qq[START_REPLICATION 0/0 TIMELINE 1 (COMPRESSION 'foo')],
+	replication => 'true');
+like(
+	$stderr,
+	qr/unrecognized compression algorithm: "foo"/,
+	'unknown compression method is rejected');
+
+done_testing();
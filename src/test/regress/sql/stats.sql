@@ -515,6 +515,58 @@ SELECT pg_stat_clear_snapshot();
 SELECT pg_stat_get_snapshot_timestamp();
 COMMIT;
 
+----
+-- pg_stat_get_relation_stats behavior
+----
+CREATE TABLE test_relstats (a int);
+INSERT INTO test_relstats SELECT generate_series(1, 10);
+UPDATE test_relstats SET a = a + 100 WHERE a <= 3;
+DELETE FROM test_relstats WHERE a BETWEEN 4 AND 5;
+SELECT count(*) FROM test_relstats;
+SELECT count(*) FROM pg_database WHERE datname = current_database();
+SELECT pg_stat_force_next_flush();
+SELECT shared, numscans, tuples_inserted, tuples_updated, tuples_deleted,
+       live_tuples, dead_tuples, mod_since_analyze, ins_since_vacuum
+  FROM pg_stat_get_relation_stats() WHERE relid = 'test_relstats'::regclass;
+-- every column matches the per-relation function of the same name
+SELECT (s.numscans, s.lastscan, s.tuples_returned, s.tuples_fetched,
+        s.tuples_inserted, s.tuples_updated, s.tuples_deleted,
+        s.tuples_hot_updated, s.tuples_newpage_updated, s.live_tuples,
+        s.dead_tuples, s.mod_since_analyze, s.ins_since_vacuum,
+        s.blocks_fetched, s.blocks_hit, s.last_vacuum_time, s.vacuum_count,
+        s.last_autovacuum_time, s.autovacuum_count, s.last_analyze_time,
+        s.analyze_count, s.last_autoanalyze_time, s.autoanalyze_count)
+       IS NOT DISTINCT FROM
+       (pg_stat_get_numscans(s.relid), pg_stat_get_lastscan(s.relid),
+        pg_stat_get_tuples_returned(s.relid), pg_stat_get_tuples_fetched(s.relid),
+        pg_stat_get_tuples_inserted(s.relid), pg_stat_get_tuples_updated(s.relid),
+        pg_stat_get_tuples_deleted(s.relid),
+        pg_stat_get_tuples_hot_updated(s.relid),
+        pg_stat_get_tuples_newpage_updated(s.relid),
+        pg_stat_get_live_tuples(s.relid), pg_stat_get_dead_tuples(s.relid),
+        pg_stat_get_mod_since_analyze(s.relid),
+        pg_stat_get_ins_since_vacuum(s.relid),
+        pg_stat_get_blocks_fetched(s.relid), pg_stat_get_blocks_hit(s.relid),
+        pg_stat_get_last_vacuum_time(s.relid), pg_stat_get_vacuum_count(s.relid),
+        pg_stat_get_last_autovacuum_time(s.relid),
+        pg_stat_get_autovacuum_count(s.relid),
+        pg_stat_get_last_analyze_time(s.relid),
+        pg_stat_get_analyze_count(s.relid),
+        pg_stat_get_last_autoanalyze_time(s.relid),
+        pg_stat_get_autoanalyze_count(s.relid)) AS same_stats
+  FROM pg_stat_get_relation_stats() s
+  WHERE s.relid = 'test_relstats'::regclass;
+-- shared catalogs are included, and flagged as such
+SELECT shared, numscans > 0 AS scanned
+  FROM pg_stat_get_relation_stats() WHERE relid = 'pg_database'::regclass;
+BEGIN;
+SET LOCAL stats_fetch_consistency = snapshot;
+SELECT count(*) > 0 AS has_stats FROM pg_stat_get_relation_stats();
+-- reads shared memory directly, without building a snapshot
+SELECT pg_stat_get_snapshot_timestamp() IS NULL AS no_snapshot;
+COMMIT;
+DROP TABLE test_relstats;
+
 ----
 -- Changing stats_fetch_consistency in a transaction.
 ----
@@ -716,6 +768,47 @@ SELECT sum(writes) AS io_sum_local_new_tblspc_writes
 SELECT :io_sum_local_new_tblspc_writes > :io_sum_local_after_writes;
 RESET temp_buffers;
 
+-- With track_io_timing enabled, each timed read is also counted in one bucket
+-- of the latency histogram.
+SET track_io_timing TO on;
+SELECT sum(count) AS io_hist_local_before_reads
+  FROM pg_stat_io_histogram
+  WHERE context = 'normal' AND object = 'temp relation' AND op = 'read' \gset
+SELECT COUNT(*) FROM test_io_local;
+SELECT pg_stat_force_next_flush();
+SELECT sum(count) AS io_hist_local_after_reads
+  FROM pg_stat_io_histogram
+  WHERE context = 'normal' AND object = 'temp relation' AND op = 'read' \gset
+SELECT :io_hist_local_after_reads > :io_hist_local_before_reads;
+RESET track_io_timing;
+
+-- Likewise for WAL writes and syncs with track_wal_io_timing enabled.  Our
+-- commits write and sync WAL themselves, but syncs are skipped if fsync is
+-- disabled or done by the writes already.
+SET track_wal_io_timing TO on;
+SET synchronous_commit TO on;
+SELECT sum(count) FILTER (WHERE op = 'write') AS write,
+       sum(count) FILTER (WHERE op = 'sync') AS sync
+  FROM pg_stat_wal_histogram \gset wal_hist_before_
+CREATE TABLE test_stats_wal_hist (a int);
+INSERT INTO test_stats_wal_hist VALUES (1);
+DROP TABLE test_stats_wal_hist;
+SELECT pg_stat_force_next_flush();
+SELECT sum(count) FILTER (WHERE op = 'write') AS write,
+       sum(count) FILTER (WHERE op = 'sync') AS sync
+  FROM pg_stat_wal_histogram \gset wal_hist_after_
+SELECT :wal_hist_after_write > :wal_hist_before_write,
+       :wal_hist_after_sync > :wal_hist_before_sync OR
+         NOT current_setting('fsync')::bool OR
+         current_setting('wal_sync_method') IN ('open_sync', 'open_datasync');
+RESET synchronous_commit;
+RESET track_wal_io_timing;
+
+-- All buckets are shown, with increasing bounds.
+SELECT count(*) AS buckets,
+       bool_and(bucket_lower_us < bucket_upper_us) AS ordered
+  FROM pg_stat_wal_histogram WHERE op = 'sync';
+
 -- Test that reuse of strategy buffers and reads of blocks into these reused
 -- buffers while VACUUMing are tracked in pg_stat_io. If there is sufficient
 -- demand for shared buffers from concurrent queries, some buffers may be
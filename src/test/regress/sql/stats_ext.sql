@@ -1690,3 +1690,33 @@ RESET SESSION AUTHORIZATION;
 DROP TABLE stats_ext_tbl;
 DROP SCHEMA tststats CASCADE;
 DROP USER regress_stats_user1;
+
+-- Long "= ANY" and "<> ALL" lists are estimated by hashing the MCV list.
+-- Check that this gives the same estimates as the per-element path, which
+-- is used for short lists and for operators without a hash opclass.
+CREATE TABLE saop_est (a int);
+INSERT INTO saop_est
+  SELECT CASE WHEN i <= 10000 THEN i % 10 ELSE i END
+  FROM generate_series(1, 20000) s(i);
+ANALYZE saop_est;
+
+CREATE OPERATOR === (procedure = int4eq, leftarg = int, rightarg = int,
+                     restrict = eqsel, negator = !==);
+CREATE OPERATOR !== (procedure = int4ne, leftarg = int, rightarg = int,
+                     restrict = neqsel, negator = ===);
+
+-- MCVs, non-MCV values and a NULL; = ANY with and without hashing
+SELECT (SELECT estimated FROM check_estimated_rows('SELECT * FROM saop_est WHERE a = ANY (ARRAY[0, 1, 2, 3, 10001, 10002, 10003, 99999, NULL])')) =
+       (SELECT estimated FROM check_estimated_rows('SELECT * FROM saop_est WHERE a === ANY (ARRAY[0, 1, 2, 3, 10001, 10002, 10003, 99999, NULL])')) AS same;
+-- the NULL contributes nothing, so this matches the 8-element list
+SELECT (SELECT estimated FROM check_estimated_rows('SELECT * FROM saop_est WHERE a = ANY (ARRAY[0, 1, 2, 3, 10001, 10002, 10003, 99999, NULL])')) =
+       (SELECT estimated FROM check_estimated_rows('SELECT * FROM saop_est WHERE a = ANY (ARRAY[0, 1, 2, 3, 10001, 10002, 10003, 99999])')) AS same;
+-- <> ALL with and without hashing
+SELECT (SELECT estimated FROM check_estimated_rows('SELECT * FROM saop_est WHERE a <> ALL (ARRAY[0, 1, 2, 3, 4, 10001, 10002, 10003, 99999])')) =
+       (SELECT estimated FROM check_estimated_rows('SELECT * FROM saop_est WHERE a !== ALL (ARRAY[0, 1, 2, 3, 4, 10001, 10002, 10003, 99999])')) AS same;
+SELECT (SELECT estimated FROM check_estimated_rows('SELECT * FROM saop_est WHERE a <> ALL (ARRAY[0, 1, 2, 3, 10001, 10002, 10003, 99999, NULL])')) =
+       (SELECT estimated FROM check_estimated_rows('SELECT * FROM saop_est WHERE a !== ALL (ARRAY[0, 1, 2, 3, 10001, 10002, 10003, 99999, NULL])')) AS same;
+
+DROP OPERATOR === (int, int);
+DROP OPERATOR !== (int, int);
+DROP TABLE saop_est;
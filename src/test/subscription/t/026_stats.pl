@@ -111,11 +111,12 @@ sub create_sub_pub_w_errors
 	# should be skipped on the subscriber since the table is already empty.
 	$node_publisher->safe_psql($db, qq(DELETE FROM $table_name;));
 
-	# Wait for the subscriber to report a delete_missing conflict.
+	# Wait for the subscriber to report a delete_missing conflict, and the
+	# transactions applied so far.
 	$node_subscriber->poll_query_until(
 		$db,
 		qq[
-	SELECT confl_delete_missing > 0
+	SELECT confl_delete_missing > 0 AND apply_xact_count > 0
 	FROM pg_stat_subscription_stats
 	WHERE subname = '$sub_name'
 	])
@@ -140,19 +141,21 @@ my ($pub1_name, $sub1_name) =
   create_sub_pub_w_errors($node_publisher, $node_subscriber, $db,
 	$table1_name);
 
-# Apply errors, sync errors, and conflicts are > 0 and stats_reset timestamp is NULL
+# Apply errors, sync errors, conflicts, and applied transactions are > 0 and
+# stats_reset timestamp is NULL
 is( $node_subscriber->safe_psql(
 		$db,
 		qq(SELECT apply_error_count > 0,
 	sync_error_count > 0,
 	confl_insert_exists > 0,
 	confl_delete_missing > 0,
+	apply_xact_count > 0,
 	stats_reset IS NULL
 	FROM pg_stat_subscription_stats
 	WHERE subname = '$sub1_name')
 	),
-	qq(t|t|t|t|t),
-	qq(Check that apply errors, sync errors, and conflicts are > 0 and stats_reset is NULL for subscription '$sub1_name'.)
+	qq(t|t|t|t|t|t),
+	qq(Check that apply errors, sync errors, conflicts, and applied transactions are > 0 and stats_reset is NULL for subscription '$sub1_name'.)
 );
 
 # Reset a single subscription
@@ -160,19 +163,21 @@ $node_subscriber->safe_psql($db,
 	qq(SELECT pg_stat_reset_subscription_stats((SELECT subid FROM pg_stat_subscription_stats WHERE subname = '$sub1_name')))
 );
 
-# Apply errors, sync errors, and conflicts are 0 and stats_reset timestamp is not NULL
+# Apply errors, sync errors, conflicts, and applied transactions are 0 and
+# stats_reset timestamp is not NULL
 is( $node_subscriber->safe_psql(
 		$db,
 		qq(SELECT apply_error_count = 0,
 	sync_error_count = 0,
 	confl_insert_exists = 0,
 	confl_delete_missing = 0,
+	apply_xact_count = 0,
 	stats_reset IS NOT NULL
 	FROM pg_stat_subscription_stats
 	WHERE subname = '$sub1_name')
 	),
-	qq(t|t|t|t|t),
-	qq(Confirm that apply errors, sync errors, and conflicts are 0 and stats_reset is not NULL after reset for subscription '$sub1_name'.)
+	qq(t|t|t|t|t|t),
+	qq(Confirm that apply errors, sync errors, conflicts, and applied transactions are 0 and stats_reset is not NULL after reset for subscription '$sub1_name'.)
 );
 
 # Get reset timestamp
@@ -322,6 +327,42 @@ $node_publisher->poll_query_until($db,
 $node_publisher->safe_psql($db,
 	qq(SELECT pg_drop_replication_slot('$sub2_name')));
 
+# Transactions applied by a parallel apply worker are counted in both
+# apply_xact_count and parallel_apply_xact_count.  Stream every transaction
+# from the publisher, so that a small one is applied in parallel.
+$node_publisher->append_conf('postgresql.conf',
+	'debug_logical_replication_streaming = immediate');
+$node_publisher->reload;
+
+my $table3_name = 'test_tab3';
+my $pub3_name = $table3_name . '_pub';
+my $sub3_name = $table3_name . '_sub';
+my $publisher_connstr = $node_publisher->connstr . qq( dbname=$db);
+
+$node_publisher->safe_psql($db, qq(CREATE TABLE $table3_name(a int)));
+$node_subscriber->safe_psql($db, qq(CREATE TABLE $table3_name(a int)));
+$node_publisher->safe_psql($db,
+	qq(CREATE PUBLICATION $pub3_name FOR TABLE $table3_name));
+$node_subscriber->safe_psql($db,
+	qq(CREATE SUBSCRIPTION $sub3_name CONNECTION '$publisher_connstr' PUBLICATION $pub3_name WITH (streaming = parallel))
+);
+
+# Parallel apply is only used once the initial table sync is done.
+$node_subscriber->wait_for_subscription_sync($node_publisher, $sub3_name);
+
+$node_publisher->safe_psql($db,
+	qq(INSERT INTO $table3_name SELECT generate_series(1, 100)));
+
+ok( $node_subscriber->poll_query_until(
+		$db,
+		qq[
+	SELECT apply_xact_count > 0 AND parallel_apply_xact_count > 0
+	FROM pg_stat_subscription_stats
+	WHERE subname = '$sub3_name'
+	]),
+	qq(Check that a streamed transaction applied in parallel is counted for subscription '$sub3_name'.)
+);
+
 $node_subscriber->stop('fast');
 $node_publisher->stop('fast');
 